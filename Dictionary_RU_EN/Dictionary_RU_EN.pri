@@ -0,0 +1,54 @@
+# Sources of the dictionary application, shared by Dictionary_RU_EN.pro and tools/
+QT      += core gui
+QT      += network
+QT      += concurrent
+QT	+= multimedia multimediawidgets
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+INCLUDEPATH += $$PWD
+
+SOURCES += \
+    $$PWD/cachewarmer.cpp \
+    $$PWD/clipboardlookup.cpp \
+    $$PWD/concordance.cpp \
+    $$PWD/dictionarybackend.cpp \
+    $$PWD/dictzipfile.cpp \
+    $$PWD/dslbackend.cpp \
+    $$PWD/entrycache.cpp \
+    $$PWD/historyexporter.cpp \
+    $$PWD/lazyjson.cpp \
+    $$PWD/lookuppopup.cpp \
+    $$PWD/mainwindow.cpp \
+    $$PWD/openrussian.cpp \
+    $$PWD/openrussianbackend.cpp \
+    $$PWD/perfstats.cpp \
+    $$PWD/phraselookup.cpp \
+    $$PWD/reverseindex.cpp \
+    $$PWD/stardictbackend.cpp \
+    $$PWD/syncbundle.cpp \
+    $$PWD/texttospeech.cpp
+
+HEADERS += \
+    $$PWD/cachewarmer.h \
+    $$PWD/clipboardlookup.h \
+    $$PWD/concordance.h \
+    $$PWD/dictionarybackend.h \
+    $$PWD/dictzipfile.h \
+    $$PWD/dslbackend.h \
+    $$PWD/entrycache.h \
+    $$PWD/historyexporter.h \
+    $$PWD/lazyjson.h \
+    $$PWD/lookuppopup.h \
+    $$PWD/mainwindow.h \
+    $$PWD/openrussian.h \
+    $$PWD/openrussianbackend.h \
+    $$PWD/perfstats.h \
+    $$PWD/phraselookup.h \
+    $$PWD/reverseindex.h \
+    $$PWD/stardictbackend.h \
+    $$PWD/syncbundle.h \
+    $$PWD/texttospeech.h
+
+# dictzip (.dict.dz) chunks are inflated with zlib; Windows builds use the copy bundled with Qt
+unix: LIBS += -lz
@@ -18,12 +18,11 @@ DEFINES += QT_DEPRECATED_WARNINGS
 # You can also select to disable deprecated APIs only up to a certain version of Qt.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
-SOURCES += \
-    main.cpp \
-    mainwindow.cpp
+# Dictionary sources shared with the tools in tools/
+include(Dictionary_RU_EN.pri)
 
-HEADERS += \
-    mainwindow.h
+SOURCES += \
+    main.cpp
 
 FORMS += \
     mainwindow.ui
@@ -0,0 +1,282 @@
+#include "cachewarmer.h"
+#include "entrycache.h"
+#include "openrussian.h"
+#include "perfstats.h"
+#include "phraselookup.h"
+#include "texttospeech.h"
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QNetworkRequest>
+#include <QRegularExpression>
+
+namespace
+{
+    const int MaxBackoffInterval = 10 * 60 * 1000;
+
+    qint64 directorySize(const QString &path)
+    {
+        qint64 size = 0;
+        QDirIterator it(path, QDir::Files);
+        while (it.hasNext()) {
+            it.next();
+            size += it.fileInfo().size();
+        }
+        return size;
+    }
+}
+
+CacheWarmer::CacheWarmer(EntryCache *cache, QObject *parent)
+    : QObject(parent)
+    , entryCache(cache)
+    , networkManager(new QNetworkAccessManager(this))
+    , candidatesLoaded(false)
+    , enabled(false)
+    , warmAudio(true)
+    , requestInterval(3000)
+    , backoffInterval(0)
+    , diskBudget(200 * 1024 * 1024)
+    , bandwidthBudget(50 * 1024 * 1024)
+{
+    timer.setSingleShot(true);
+    connect(&timer, &QTimer::timeout, this, &CacheWarmer::warmNext);
+    connect(networkManager, &QNetworkAccessManager::finished, this, &CacheWarmer::onReply);
+}
+
+void CacheWarmer::setEnabled(bool enable)
+{
+    enabled = enable;
+    if (!enabled) {
+        pause();
+    }
+}
+
+bool CacheWarmer::isEnabled() const
+{
+    return enabled;
+}
+
+void CacheWarmer::setWarmAudio(bool warm)
+{
+    warmAudio = warm;
+}
+
+void CacheWarmer::setRequestInterval(int milliseconds)
+{
+    requestInterval = qMax(100, milliseconds);
+}
+
+void CacheWarmer::setDiskBudget(qint64 bytes)
+{
+    diskBudget = bytes;
+}
+
+void CacheWarmer::setBandwidthBudget(qint64 bytes)
+{
+    bandwidthBudget = bytes;
+}
+
+CacheWarmer::Stats CacheWarmer::stats() const
+{
+    Stats current = counters;
+    current.queued = queue.size();
+    return current;
+}
+
+void CacheWarmer::loadCandidates()
+{
+    candidatesLoaded = true;
+    counters.diskUsed = directorySize(entryCache->directory()) + directorySize("word_audio");
+
+    // Bundled frequency-ranked list, most frequent first
+    QFile file(":/data/frequency_ru.txt");
+    if (file.open(QIODevice::ReadOnly)) {
+        for (const QByteArray &line : file.readAll().split('\n')) {
+            QString word = QString::fromUtf8(line).trimmed();
+            if (!word.isEmpty() && !word.startsWith('#') && !seen.contains(word)) {
+                seen.insert(word);
+                lemmas.insert(word);
+                queue << word;
+            }
+        }
+    }
+}
+
+void CacheWarmer::addRecentWord(const QString &word)
+{
+    QJsonObject wordData;
+    if (!entryCache->lookup(word, &wordData)) return;
+
+    if (!candidatesLoaded) {
+        loadCandidates();
+    }
+
+    // Words met in the examples of a looked-up word are likely to be looked up next.
+    // Sentences use inflected forms ("берегу") that OpenRussian has no page for,
+    // so only tokens that are already lemmas of the bundled list are moved up.
+    static const QRegularExpression cyrillic("^[а-яё-]{2,}$");
+    QStringList adjacent;
+    for (const QJsonValue &sentence : wordData["sentences"].toArray()) {
+        QString ru = sentence.toObject()["ru"].toString();
+        ru.remove(QRegularExpression("<[^>]*>"));
+        for (const QString &token : PhraseLookup::tokenize(ru)) {
+            QString normalized = PhraseLookup::normalizeToken(token);
+            if (cyrillic.match(normalized).hasMatch() && lemmas.contains(normalized) && !adjacent.contains(normalized)) {
+                adjacent << normalized;
+            }
+        }
+    }
+    enqueueFront(adjacent);
+}
+
+void CacheWarmer::enqueueFront(const QStringList &words)
+{
+    for (int i = words.size() - 1; i >= 0; --i) {
+        queue.removeOne(words[i]);
+        queue.prepend(words[i]);
+        seen.insert(words[i]);
+    }
+}
+
+void CacheWarmer::resume()
+{
+    if (!enabled || counters.running) return;
+
+    if (!candidatesLoaded) {
+        loadCandidates();
+    }
+
+    counters.running = true;
+    scheduleNext(requestInterval);
+    emit progressChanged(stats());
+}
+
+void CacheWarmer::pause()
+{
+    if (!counters.running) return;
+
+    // A request already on the wire is allowed to finish
+    counters.running = false;
+    timer.stop();
+    emit progressChanged(stats());
+}
+
+void CacheWarmer::abort()
+{
+    pause();
+    if (activeReply) {
+        activeReply->abort();
+    }
+}
+
+bool CacheWarmer::withinBudget() const
+{
+    return (diskBudget <= 0 || counters.diskUsed < diskBudget)
+            && (bandwidthBudget <= 0 || counters.bytesDownloaded < bandwidthBudget);
+}
+
+void CacheWarmer::scheduleNext(int delay)
+{
+    if (counters.running) {
+        timer.start(delay);
+    }
+}
+
+void CacheWarmer::warmNext()
+{
+    if (!counters.running || activeReply) return;
+
+    if (!withinBudget()) {
+        counters.budgetExhausted = true;
+        counters.running = false;
+        emit progressChanged(stats());
+        return;
+    }
+
+    while (!queue.isEmpty()) {
+        QString word = queue.first();
+
+        QNetworkRequest request;
+        QString kind;
+        if (!entryCache->contains(word)) {
+            request.setUrl(OpenRussian::lookupUrl(word));
+            kind = "entry";
+        } else if (warmAudio && !QFile::exists(TextToSpeech::localFilePath(word, "ru"))) {
+            request.setUrl(TextToSpeech::speechUrl(word, "ru"));
+            request.setRawHeader("Referer", "https://translate.google.com/");
+            kind = "audio";
+        } else {
+            // Nothing left to do for this word
+            queue.removeFirst();
+            continue;
+        }
+
+        activeReply = networkManager->get(request);
+        activeReply->setProperty("word", word);
+        activeReply->setProperty("kind", kind);
+        PerfStats::instance().add(PerfStats::InFlightRequests);
+        return;
+    }
+
+    // Everything is warm
+    counters.running = false;
+    emit progressChanged(stats());
+}
+
+void CacheWarmer::onReply(QNetworkReply *reply)
+{
+    reply->deleteLater();
+    activeReply = nullptr;
+    PerfStats::instance().add(PerfStats::InFlightRequests, -1);
+
+    QString word = reply->property("word").toString();
+    QString kind = reply->property("kind").toString();
+    int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+    if (reply->error() == QNetworkReply::OperationCanceledError) {
+        // Cancelled by abort(); the word stays queued for the next run
+        return;
+    }
+    if (reply->error() != QNetworkReply::NoError) {
+        counters.failures++;
+        if (status == 429 || status >= 500 || status == 0) {
+            // Throttled or unreachable: keep the word and back off
+            backoffInterval = qMin(MaxBackoffInterval, qMax(requestInterval, backoffInterval * 2));
+        } else {
+            // Unknown word
+            queue.removeOne(word);
+        }
+        emit progressChanged(stats());
+        scheduleNext(backoffInterval);
+        return;
+    }
+    backoffInterval = 0;
+
+    QByteArray data = reply->readAll();
+    counters.bytesDownloaded += data.size();
+    PerfStats::instance().add(PerfStats::BytesDownloaded, data.size());
+
+    if (kind == "entry") {
+        QJsonObject wordData;
+        if (OpenRussian::extractWordData(data, &wordData)) {
+            entryCache->store(word, wordData);
+            counters.entriesWarmed++;
+            counters.diskUsed += QJsonDocument(wordData).toJson(QJsonDocument::Compact).size();
+        } else {
+            queue.removeOne(word);
+        }
+    } else {
+        QFile file(TextToSpeech::localFilePath(word, "ru"));
+        if (file.open(QIODevice::WriteOnly)) {
+            file.write(data);
+            counters.audioWarmed++;
+            counters.diskUsed += data.size();
+        }
+        queue.removeOne(word);
+    }
+
+    emit progressChanged(stats());
+    scheduleNext(requestInterval);
+}
@@ -0,0 +1,86 @@
+#ifndef CACHEWARMER_H
+#define CACHEWARMER_H
+
+#include <QObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QPointer>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+
+class EntryCache;
+
+// Fills the entry cache and the word_audio folder in the background while the
+// window is idle: the bundled frequency list of lemmas, with the ones met in
+// the examples of recently looked-up words moved to the front. One request at
+// a time, rate-limited, within disk and bandwidth budgets.
+class CacheWarmer : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Stats
+    {
+        int entriesWarmed = 0;
+        int audioWarmed = 0;
+        int failures = 0;
+        int queued = 0;
+        qint64 bytesDownloaded = 0;
+        qint64 diskUsed = 0;
+        bool running = false;
+        bool budgetExhausted = false;
+    };
+
+    CacheWarmer(EntryCache *cache, QObject *parent = nullptr);
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+    void setWarmAudio(bool warmAudio);
+    void setRequestInterval(int milliseconds);
+    void setDiskBudget(qint64 bytes);       // 0 = unlimited
+    void setBandwidthBudget(qint64 bytes);  // per session, 0 = unlimited
+
+    // Queue the words around a looked-up word (from its example sentences)
+    void addRecentWord(const QString &word);
+
+    void resume();
+    void pause();
+    // Pause and cancel the request on the wire, so nothing is written until resume()
+    void abort();
+
+    Stats stats() const;
+
+signals:
+    void progressChanged(const CacheWarmer::Stats &stats);
+
+private slots:
+    void warmNext();
+    void onReply(QNetworkReply *reply);
+
+private:
+    void loadCandidates();
+    bool withinBudget() const;
+    void enqueueFront(const QStringList &words);
+    void scheduleNext(int delay);
+
+    EntryCache *entryCache;
+    QNetworkAccessManager *networkManager;
+    QPointer<QNetworkReply> activeReply;
+    QTimer timer;
+
+    QStringList queue;
+    QSet<QString> seen;
+    QSet<QString> lemmas;
+    bool candidatesLoaded;
+
+    bool enabled;
+    bool warmAudio;
+    int requestInterval;
+    int backoffInterval;
+    qint64 diskBudget;
+    qint64 bandwidthBudget;
+    Stats counters;
+};
+
+#endif // CACHEWARMER_H
@@ -0,0 +1,145 @@
+#include "clipboardlookup.h"
+#include "dictionarybackend.h"
+#include "entrycache.h"
+#include "openrussianbackend.h"
+#include "perfstats.h"
+#include "phraselookup.h"
+#include <QClipboard>
+#include <QGuiApplication>
+#include <QMimeData>
+#include <QRegularExpression>
+
+namespace
+{
+    // Longer text is a paragraph, not a word worth a popup
+    const int MaxTextLength = 64;
+}
+
+ClipboardLookup::ClipboardLookup(EntryCache *cache, QObject *parent)
+    : QObject(parent)
+    , entryCache(cache)
+    , backend(new OpenRussianBackend(cache, this))
+    , debounceTimer(new QTimer(this))
+    , enabled(false)
+    , changedWhileActive(false)
+{
+    debounceTimer->setSingleShot(true);
+    debounceTimer->setInterval(400);
+
+    connect(debounceTimer, &QTimer::timeout, this, &ClipboardLookup::onDebounceTimeout);
+    connect(backend, &DictionaryBackend::lookupFinished, this, &ClipboardLookup::onBackendLookupFinished);
+}
+
+void ClipboardLookup::setLocalBackends(const QList<LocalDictionaryBackend *> &backends)
+{
+    localBackends = backends;
+}
+
+void ClipboardLookup::setEnabled(bool enabled)
+{
+    if (this->enabled == enabled) return;
+    this->enabled = enabled;
+
+    QClipboard *clipboard = QGuiApplication::clipboard();
+    if (enabled) {
+        connect(clipboard, &QClipboard::dataChanged, this, &ClipboardLookup::onClipboardChanged);
+    } else {
+        disconnect(clipboard, &QClipboard::dataChanged, this, &ClipboardLookup::onClipboardChanged);
+        debounceTimer->stop();
+        queuedWord.clear();
+    }
+}
+
+bool ClipboardLookup::isEnabled() const
+{
+    return enabled;
+}
+
+void ClipboardLookup::setDebounceInterval(int milliseconds)
+{
+    debounceTimer->setInterval(milliseconds);
+}
+
+void ClipboardLookup::ignoreText(const QString &text)
+{
+    ownText = text;
+}
+
+QString ClipboardLookup::wordFromText(const QString &text)
+{
+    if (text.size() > MaxTextLength) return QString();
+
+    QStringList tokens = PhraseLookup::tokenize(text);
+    if (tokens.size() != 1) return QString();
+
+    static const QRegularExpression cyrillic("^[\\x{0400}-\\x{04FF}\\x{0300}\\x{0301}-]+$");
+    if (!cyrillic.match(tokens.first()).hasMatch()) return QString();
+
+    return PhraseLookup::normalizeToken(tokens.first());
+}
+
+void ClipboardLookup::onClipboardChanged()
+{
+    // Only restart the timer here; the clipboard is read once the burst is over.
+    // Whether the copy came from inside the application has to be decided now:
+    // by the timeout the user may have switched windows.
+    changedWhileActive = QGuiApplication::applicationState() == Qt::ApplicationActive;
+    debounceTimer->start();
+}
+
+void ClipboardLookup::onDebounceTimeout()
+{
+    // Copies made inside the application itself are not lookups
+    if (changedWhileActive) return;
+
+    const QMimeData *mimeData = QGuiApplication::clipboard()->mimeData();
+    if (!mimeData || !mimeData->hasText()) return;
+
+    QString text = mimeData->text();
+    if (text == ownText) return;
+
+    QString word = wordFromText(text);
+    if (!word.isEmpty()) {
+        resolve(word);
+    }
+}
+
+void ClipboardLookup::resolve(const QString &word)
+{
+    QJsonObject localEntry;
+    bool foundLocally = LocalDictionaryBackend::findInAll(localBackends, word, &localEntry);
+
+    QJsonObject wordData;
+    bool cached = entryCache->lookup(word, &wordData);
+    PerfStats::instance().add(cached ? PerfStats::CacheHits : PerfStats::CacheMisses);
+
+    if (cached) {
+        emit wordResolved(word, foundLocally ? DictionaryBackend::mergeEntries(wordData, localEntry) : wordData, true);
+        return;
+    }
+    if (foundLocally) {
+        emit wordResolved(word, localEntry, true);
+        return;
+    }
+
+    if (!fetchingWord.isEmpty()) {
+        if (word != fetchingWord) queuedWord = word;
+        return;
+    }
+    fetchingWord = word;
+    backend->lookup(word);
+}
+
+void ClipboardLookup::onBackendLookupFinished(const QString &word, bool found, const QJsonObject &wordData, const QString &errorString)
+{
+    Q_UNUSED(errorString);
+
+    fetchingWord.clear();
+    emit wordResolved(word, wordData, found);
+
+    if (!queuedWord.isEmpty()) {
+        QString next = queuedWord;
+        queuedWord.clear();
+        resolve(next);
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef CLIPBOARDLOOKUP_H
+#define CLIPBOARDLOOKUP_H
+
+#include <QObject>
+#include <QJsonObject>
+#include <QTimer>
+
+class EntryCache;
+class LocalDictionaryBackend;
+class OpenRussianBackend;
+
+// Looks up Russian words copied to the clipboard in other applications.
+//
+// Clipboard changes are debounced, so a burst of copies results in a single lookup
+// of the last one. Text that is not a single Cyrillic word, or is too long, is ignored.
+// The cache and local dictionaries are tried first; at most one OpenRussian request
+// is in flight, a word copied meanwhile replaces any word still waiting for it.
+class ClipboardLookup : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ClipboardLookup(EntryCache *cache, QObject *parent = nullptr);
+
+    void setLocalBackends(const QList<LocalDictionaryBackend *> &backends);
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+    void setDebounceInterval(int milliseconds);
+
+    // Text the application puts on the clipboard itself, which must not trigger a lookup
+    void ignoreText(const QString &text);
+
+    // The word to look up in copied text, or an empty string
+    static QString wordFromText(const QString &text);
+
+signals:
+    void wordResolved(const QString &word, const QJsonObject &wordData, bool found);
+
+private slots:
+    void onClipboardChanged();
+    void onDebounceTimeout();
+    void onBackendLookupFinished(const QString &word, bool found, const QJsonObject &wordData, const QString &errorString);
+
+private:
+    void resolve(const QString &word);
+
+    EntryCache *entryCache;
+    QList<LocalDictionaryBackend *> localBackends;
+    OpenRussianBackend *backend;
+    QTimer *debounceTimer;
+    bool enabled;
+    bool changedWhileActive;
+
+    QString ownText;
+    QString fetchingWord;
+    QString queuedWord;
+};
+
+#endif // CLIPBOARDLOOKUP_H
@@ -0,0 +1,455 @@
+#include "concordance.h"
+#include "entrycache.h"
+#include <QCryptographicHash>
+#include <QDir>
+#include <QJsonArray>
+#include <QRegularExpression>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    const char IndexMagic[4] = {'C', 'S', 'A', '1'};
+    const int IndexHeaderSize = 16;          // magic, reserved, indexed corpus size
+    const int ReindexTailSize = 256 * 1024;  // rebuild the suffix array beyond this
+
+    // Decode the UTF-8 character at pos, folded for matching; 0 at the end of the Russian field
+    uint nextFolded(const uchar *text, qint64 size, qint64 *pos)
+    {
+        if (*pos >= size) return 0;
+
+        uchar c = text[*pos];
+        if (c == '\t' || c == '\n') return 0;
+
+        uint codePoint;
+        int length;
+        if (c < 0x80) {
+            codePoint = c;
+            length = 1;
+        } else if ((c & 0xE0) == 0xC0) {
+            codePoint = c & 0x1F;
+            length = 2;
+        } else if ((c & 0xF0) == 0xE0) {
+            codePoint = c & 0x0F;
+            length = 3;
+        } else {
+            codePoint = c & 0x07;
+            length = 4;
+        }
+        for (int i = 1; i < length && *pos + i < size; ++i) {
+            codePoint = (codePoint << 6) | (text[*pos + i] & 0x3F);
+        }
+        *pos += length;
+
+        codePoint = QChar::toLower(codePoint);
+        return codePoint == 0x0451 ? 0x0435 : codePoint;  // ё matches е
+    }
+
+    int compareSuffixes(const uchar *text, qint64 size, qint64 a, qint64 b)
+    {
+        for (;;) {
+            uint ca = nextFolded(text, size, &a);
+            uint cb = nextFolded(text, size, &b);
+            if (ca != cb) return ca < cb ? -1 : 1;
+            if (ca == 0) return 0;
+        }
+    }
+
+    // Compare the suffix at pos with the query; a suffix starting with the query compares equal
+    int compareQuery(const uchar *text, qint64 size, qint64 pos, const QVector<uint> &query)
+    {
+        for (uint q : query) {
+            uint c = nextFolded(text, size, &pos);
+            if (c != q) return c < q ? -1 : 1;
+        }
+        return 0;
+    }
+
+    QVector<uint> foldQuery(const QString &query)
+    {
+        QByteArray utf8 = query.toUtf8();
+        const uchar *text = reinterpret_cast<const uchar *>(utf8.constData());
+        QVector<uint> folded;
+        qint64 pos = 0;
+        while (uint c = nextFolded(text, utf8.size(), &pos)) {
+            folded << c;
+        }
+        return folded;
+    }
+
+    QString cleanSentence(QString text)
+    {
+        text.remove(QRegularExpression("<[^>]*>"));
+        text.replace("&#x27;", "'");
+        return text.simplified();
+    }
+
+    // 64 bits of SHA-1: a 32-bit qHash starts dropping distinct sentences
+    // as collisions once the corpus reaches tens of thousands of lines
+    quint64 sentenceHash(const QByteArray &ru)
+    {
+        quint64 hash;
+        memcpy(&hash, QCryptographicHash::hash(ru, QCryptographicHash::Sha1).constData(), sizeof(hash));
+        return hash;
+    }
+}
+
+Concordance::Concordance(const QString &directory, QObject *parent)
+    : QObject(parent)
+    , corpusPath(directory + "/corpus.txt")
+    , indexPath(directory + "/corpus.sa")
+    , indexData(nullptr)
+    , corpus(nullptr)
+    , corpusMappedSize(0)
+    , suffixes(nullptr)
+    , suffixCount(0)
+    , indexedSize(0)
+    , sentences(0)
+    , importing(false)
+{
+    QDir().mkpath(directory);
+    connect(&indexer, &QFutureWatcher<qint64>::finished, this, &Concordance::onIndexingFinished);
+}
+
+Concordance::~Concordance()
+{
+    indexer.waitForFinished();
+    unmapFiles();
+}
+
+void Concordance::open(const QString &entryCacheDirectory)
+{
+    if (!QFile::exists(corpusPath)) {
+        // First run: collect the sentences of everything already cached
+        importing = true;
+        indexer.setFuture(QtConcurrent::run(&Concordance::buildIndex, corpusPath, indexPath, entryCacheDirectory));
+        return;
+    }
+
+    mapFiles();
+    loadTail();
+    loadSentenceHashes(QByteArray::fromRawData(reinterpret_cast<const char *>(corpus), int(indexedSize)));
+    loadSentenceHashes(tail);
+
+    if (!tail.isEmpty()) {
+        startIndexing();
+    }
+}
+
+int Concordance::sentenceCount() const
+{
+    return sentences;
+}
+
+bool Concordance::isIndexing() const
+{
+    return indexer.isRunning();
+}
+
+void Concordance::mapFiles()
+{
+    corpusFile.setFileName(corpusPath);
+    if (corpusFile.open(QIODevice::ReadOnly) && corpusFile.size() > 0) {
+        corpusMappedSize = corpusFile.size();
+        corpus = corpusFile.map(0, corpusMappedSize);
+        if (!corpus) corpusMappedSize = 0;
+    }
+
+    indexFile.setFileName(indexPath);
+    if (corpus && indexFile.open(QIODevice::ReadOnly) && indexFile.size() >= IndexHeaderSize) {
+        indexData = indexFile.map(0, indexFile.size());
+    }
+
+    qint64 size = 0;
+    if (indexData && memcmp(indexData, IndexMagic, 4) == 0) {
+        memcpy(&size, indexData + 8, sizeof(size));
+    }
+
+    if (size > 0 && size <= corpusMappedSize) {
+        indexedSize = size;
+        suffixes = reinterpret_cast<const quint32 *>(indexData + IndexHeaderSize);
+        suffixCount = (indexFile.size() - IndexHeaderSize) / qint64(sizeof(quint32));
+    } else {
+        // Missing or stale index: everything is tail until it is rebuilt
+        indexedSize = 0;
+        suffixes = nullptr;
+        suffixCount = 0;
+    }
+}
+
+void Concordance::unmapFiles()
+{
+    if (corpus) {
+        corpusFile.unmap(const_cast<uchar *>(corpus));
+        corpus = nullptr;
+    }
+    if (indexData) {
+        indexFile.unmap(const_cast<uchar *>(indexData));
+        indexData = nullptr;
+    }
+    corpusFile.close();
+    indexFile.close();
+    corpusMappedSize = 0;
+    suffixes = nullptr;
+    suffixCount = 0;
+}
+
+void Concordance::loadTail()
+{
+    tail.clear();
+
+    QFile file(corpusPath);
+    if (file.open(QIODevice::ReadOnly) && file.seek(indexedSize)) {
+        tail = file.readAll();
+    }
+}
+
+void Concordance::loadSentenceHashes(const QByteArray &text)
+{
+    int lineStart = 0;
+    while (lineStart < text.size()) {
+        int lineEnd = text.indexOf('\n', lineStart);
+        if (lineEnd < 0) lineEnd = text.size();
+
+        int ruEnd = text.indexOf('\t', lineStart);
+        if (ruEnd < 0 || ruEnd > lineEnd) ruEnd = lineEnd;
+        knownSentences.insert(sentenceHash(text.mid(lineStart, ruEnd - lineStart)));
+
+        lineStart = lineEnd + 1;
+    }
+    sentences = knownSentences.size();
+}
+
+QByteArray Concordance::recordsForEntry(const QString &word, const QJsonObject &wordData, QSet<quint64> *known)
+{
+    QList<QPair<QString, QString>> pairs;
+    for (const QJsonValue &sentence : wordData["sentences"].toArray()) {
+        QJsonObject object = sentence.toObject();
+        pairs << qMakePair(object["ru"].toString(), object["tl"].toString());
+    }
+    for (const QJsonValue &translation : wordData["translations"].toArray()) {
+        QJsonObject object = translation.toObject();
+        pairs << qMakePair(object["exampleRu"].toString(), object["exampleTl"].toString());
+    }
+
+    QByteArray records;
+    for (const QPair<QString, QString> &pair : pairs) {
+        QByteArray ru = cleanSentence(pair.first).toUtf8();
+        if (ru.isEmpty()) continue;
+
+        quint64 hash = sentenceHash(ru);
+        if (known->contains(hash)) continue;
+        known->insert(hash);
+
+        records += ru + '\t' + cleanSentence(pair.second).toUtf8() + '\t' + word.simplified().toUtf8() + '\n';
+    }
+    return records;
+}
+
+void Concordance::addEntry(const QString &word, const QJsonObject &wordData)
+{
+    // The worker owns corpus.txt while it imports the entry cache
+    if (importing) {
+        queuedEntries.append(qMakePair(word, wordData));
+        return;
+    }
+
+    QByteArray records = recordsForEntry(word, wordData, &knownSentences);
+    sentences = knownSentences.size();
+    if (records.isEmpty()) return;
+
+    appendRecords(records);
+    if (tail.size() > ReindexTailSize) {
+        startIndexing();
+    }
+}
+
+void Concordance::appendRecords(const QByteArray &records)
+{
+    QFile file(corpusPath);
+    if (file.open(QIODevice::Append)) {
+        file.write(records);
+        tail += records;
+    }
+}
+
+void Concordance::startIndexing()
+{
+    if (indexer.isRunning()) return;
+    indexer.setFuture(QtConcurrent::run(&Concordance::buildIndex, corpusPath, indexPath, QString()));
+}
+
+qint64 Concordance::buildIndex(const QString &corpusPath, const QString &indexPath, const QString &importDirectory)
+{
+    if (!importDirectory.isEmpty()) {
+        QFile output(corpusPath);
+        if (!output.open(QIODevice::WriteOnly)) return -1;
+
+        QSet<quint64> known;
+        EntryCache::readDirectory(importDirectory, [&output, &known](const QString &word, const QJsonObject &wordData) {
+            output.write(recordsForEntry(word, wordData, &known));
+        });
+
+        // Flush before the corpus is mapped below; a short write must not be indexed
+        output.close();
+        if (output.error() != QFileDevice::NoError) return -1;
+    }
+
+    QFile input(corpusPath);
+    if (!input.open(QIODevice::ReadOnly) || input.size() == 0) return -1;
+
+    const qint64 mappedSize = input.size();
+    const uchar *text = input.map(0, mappedSize);
+    if (!text) return -1;
+
+    // Only index complete lines; the GUI thread may be appending meanwhile
+    qint64 size = mappedSize;
+    while (size > 0 && text[size - 1] != '\n') size--;
+
+    // Every character start of the Russian field is a suffix
+    std::vector<quint32> positions;
+    positions.reserve(size_t(size / 2));
+    qint64 pos = 0;
+    while (pos < size) {
+        bool inRussian = true;
+        for (; pos < size && text[pos] != '\n'; ++pos) {
+            if (text[pos] == '\t') inRussian = false;
+            if (inRussian && (text[pos] & 0xC0) != 0x80 && text[pos] != ' ') {
+                positions.push_back(quint32(pos));
+            }
+        }
+        pos++;
+    }
+
+    std::sort(positions.begin(), positions.end(), [text, size](quint32 a, quint32 b) {
+        int result = compareSuffixes(text, size, a, b);
+        return result != 0 ? result < 0 : a < b;
+    });
+    input.unmap(const_cast<uchar *>(text));
+
+    QFile output(indexPath + ".tmp");
+    if (!output.open(QIODevice::WriteOnly)) return -1;
+
+    char header[IndexHeaderSize] = {};
+    memcpy(header, IndexMagic, 4);
+    memcpy(header + 8, &size, sizeof(size));
+    output.write(header, IndexHeaderSize);
+    output.write(reinterpret_cast<const char *>(positions.data()), qint64(positions.size() * sizeof(quint32)));
+
+    // Buffered data is only written out by close(); errors from that count too
+    output.close();
+    if (output.error() != QFileDevice::NoError) {
+        QFile::remove(indexPath + ".tmp");
+        return -1;
+    }
+    return size;
+}
+
+void Concordance::onIndexingFinished()
+{
+    qint64 size = indexer.result();
+
+    // Swap in the new suffix array (files must be unmapped before they can be replaced on Windows)
+    unmapFiles();
+    if (size > 0) {
+        QFile::remove(indexPath);
+        QFile::rename(indexPath + ".tmp", indexPath);
+    }
+    mapFiles();
+    loadTail();
+
+    if (importing) {
+        importing = false;
+        knownSentences.clear();
+        loadSentenceHashes(QByteArray::fromRawData(reinterpret_cast<const char *>(corpus), int(indexedSize)));
+        loadSentenceHashes(tail);
+
+        QList<QPair<QString, QJsonObject>> queued = queuedEntries;
+        queuedEntries.clear();
+        for (const QPair<QString, QJsonObject> &entry : queued) {
+            addEntry(entry.first, entry.second);
+        }
+    }
+
+    emit indexUpdated();
+
+    if (tail.size() > ReindexTailSize) {
+        startIndexing();
+    }
+}
+
+Concordance::Hit Concordance::hitAt(const uchar *text, qint64 textSize, qint64 offset, int queryLength) const
+{
+    const int contextLength = 50;
+
+    qint64 lineStart = offset;
+    while (lineStart > 0 && text[lineStart - 1] != '\n') lineStart--;
+    qint64 lineEnd = offset;
+    while (lineEnd < textSize && text[lineEnd] != '\n') lineEnd++;
+
+    QByteArray line = QByteArray::fromRawData(reinterpret_cast<const char *>(text + lineStart), int(lineEnd - lineStart));
+    QList<QByteArray> fields = line.split('\t');
+
+    qint64 matchEnd = offset;
+    for (int i = 0; i < queryLength; ++i) {
+        nextFolded(text, textSize, &matchEnd);
+    }
+    qint64 ruEnd = lineStart + fields.value(0).size();
+
+    Hit hit;
+    hit.left = QString::fromUtf8(reinterpret_cast<const char *>(text + lineStart), int(offset - lineStart)).right(contextLength);
+    hit.match = QString::fromUtf8(reinterpret_cast<const char *>(text + offset), int(matchEnd - offset));
+    hit.right = QString::fromUtf8(reinterpret_cast<const char *>(text + matchEnd), int(ruEnd - matchEnd)).left(contextLength);
+    hit.translation = QString::fromUtf8(fields.value(1));
+    hit.headword = QString::fromUtf8(fields.value(2));
+    return hit;
+}
+
+QVector<Concordance::Hit> Concordance::search(const QString &query, int limit) const
+{
+    // "-ться бы": a leading hyphen marks a word ending, which substring search covers anyway
+    QString trimmed = query.trimmed();
+    while (trimmed.startsWith('-')) trimmed.remove(0, 1);
+
+    QVector<uint> folded = foldQuery(trimmed);
+    QVector<Hit> hits;
+    if (folded.isEmpty()) return hits;
+
+    // Binary search for the range of suffixes starting with the query
+    if (suffixes) {
+        qint64 low = 0;
+        qint64 high = suffixCount;
+        while (low < high) {
+            qint64 middle = low + (high - low) / 2;
+            if (compareQuery(corpus, indexedSize, suffixes[middle], folded) < 0) low = middle + 1;
+            else high = middle;
+        }
+        qint64 first = low;
+
+        high = suffixCount;
+        while (low < high) {
+            qint64 middle = low + (high - low) / 2;
+            if (compareQuery(corpus, indexedSize, suffixes[middle], folded) <= 0) low = middle + 1;
+            else high = middle;
+        }
+
+        for (qint64 i = first; i < low && hits.size() < limit; ++i) {
+            hits << hitAt(corpus, indexedSize, suffixes[i], folded.size());
+        }
+    }
+
+    // Sentences added since the index was built
+    const uchar *text = reinterpret_cast<const uchar *>(tail.constData());
+    qint64 size = tail.size();
+    bool inRussian = true;
+    for (qint64 pos = 0; pos < size && hits.size() < limit; ++pos) {
+        if (text[pos] == '\n') inRussian = true;
+        else if (text[pos] == '\t') inRussian = false;
+        else if (inRussian && (text[pos] & 0xC0) != 0x80 && compareQuery(text, size, pos, folded) == 0) {
+            hits << hitAt(text, size, pos, folded.size());
+        }
+    }
+
+    return hits;
+}
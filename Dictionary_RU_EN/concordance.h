@@ -0,0 +1,87 @@
+#ifndef CONCORDANCE_H
+#define CONCORDANCE_H
+
+#include <QObject>
+#include <QFile>
+#include <QFutureWatcher>
+#include <QJsonObject>
+#include <QPair>
+#include <QSet>
+#include <QVector>
+
+// Searchable corpus of every example sentence of the fetched entries.
+//
+// Sentences are appended to corpus.txt ("ru<TAB>en<TAB>headword" per line).
+// corpus.sa is a suffix array over the Russian text: the byte offsets of all
+// suffixes, sorted case-insensitively (ё = е). Both files are memory-mapped, so
+// any substring is found with two binary searches. Sentences added since the
+// last index build are kept in a small in-memory tail that is scanned directly;
+// the suffix array is rebuilt in a worker thread once the tail grows.
+class Concordance : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Hit
+    {
+        QString left;
+        QString match;
+        QString right;
+        QString translation;
+        QString headword;
+    };
+
+    explicit Concordance(const QString &directory, QObject *parent = nullptr);
+    ~Concordance();
+
+    // Map the corpus, importing the entry cache on first use
+    void open(const QString &entryCacheDirectory);
+
+    void addEntry(const QString &word, const QJsonObject &wordData);
+    QVector<Hit> search(const QString &query, int limit = 200) const;
+
+    int sentenceCount() const;
+    bool isIndexing() const;
+
+signals:
+    void indexUpdated();
+
+private slots:
+    void onIndexingFinished();
+
+private:
+    void appendRecords(const QByteArray &records);
+    void startIndexing();
+    void mapFiles();
+    void unmapFiles();
+    void loadTail();
+    void loadSentenceHashes(const QByteArray &text);
+    Hit hitAt(const uchar *text, qint64 textSize, qint64 offset, int queryLength) const;
+
+    static QByteArray recordsForEntry(const QString &word, const QJsonObject &wordData, QSet<quint64> *known);
+    static qint64 buildIndex(const QString &corpusPath, const QString &indexPath, const QString &importDirectory);
+
+    QString corpusPath;
+    QString indexPath;
+
+    QFile corpusFile;
+    QFile indexFile;
+    const uchar *indexData;
+    const uchar *corpus;
+    qint64 corpusMappedSize;
+    const quint32 *suffixes;
+    qint64 suffixCount;
+    qint64 indexedSize;
+
+    // Records appended after indexedSize
+    QByteArray tail;
+
+    QSet<quint64> knownSentences;
+    int sentences;
+
+    QFutureWatcher<qint64> indexer;
+    bool importing;
+    QList<QPair<QString, QJsonObject>> queuedEntries;
+};
+
+#endif // CONCORDANCE_H
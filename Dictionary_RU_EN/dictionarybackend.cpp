@@ -0,0 +1,95 @@
+#include "dictionarybackend.h"
+#include "dslbackend.h"
+#include "stardictbackend.h"
+#include <QDebug>
+#include <QDir>
+#include <QJsonArray>
+#include <QThread>
+
+DictionaryBackend::DictionaryBackend(QObject *parent)
+    : QObject(parent)
+{
+}
+
+QJsonObject DictionaryBackend::mergeEntries(const QJsonObject &entry, const QJsonObject &extra)
+{
+    QJsonObject merged = entry;
+
+    QJsonArray translations = entry["translations"].toArray();
+    for (const QJsonValue &translation : extra["translations"].toArray()) {
+        translations.append(translation);
+    }
+    merged["translations"] = translations;
+
+    QJsonArray sentences = entry["sentences"].toArray();
+    for (const QJsonValue &sentence : extra["sentences"].toArray()) {
+        sentences.append(sentence);
+    }
+    merged["sentences"] = sentences;
+
+    return merged;
+}
+
+LocalDictionaryBackend::LocalDictionaryBackend(QObject *parent)
+    : DictionaryBackend(parent)
+{
+}
+
+bool LocalDictionaryBackend::isLocal() const
+{
+    return true;
+}
+
+void LocalDictionaryBackend::lookup(const QString &word)
+{
+    QJsonObject wordData;
+    bool found = find(word, &wordData);
+    emit lookupFinished(word, found, wordData, found ? QString() : QString("Not found in %1").arg(name()));
+}
+
+QList<LocalDictionaryBackend *> LocalDictionaryBackend::loadDirectory(const QString &directory, QThread *ownerThread)
+{
+    QList<LocalDictionaryBackend *> backends;
+
+    QDir dir(directory);
+    if (!dir.exists()) {
+        return backends;
+    }
+
+    for (const QString &fileName : dir.entryList(QStringList() << "*.ifo", QDir::Files, QDir::Name)) {
+        StarDictBackend *backend = new StarDictBackend();
+        if (backend->open(dir.filePath(fileName))) {
+            backend->moveToThread(ownerThread);
+            backends << backend;
+        } else {
+            qWarning() << "Could not open StarDict dictionary" << fileName;
+            delete backend;
+        }
+    }
+
+    for (const QString &fileName : dir.entryList(QStringList() << "*.dsl", QDir::Files, QDir::Name)) {
+        DslBackend *backend = new DslBackend();
+        if (backend->open(dir.filePath(fileName))) {
+            backend->moveToThread(ownerThread);
+            backends << backend;
+        } else {
+            qWarning() << "Could not open DSL dictionary" << fileName;
+            delete backend;
+        }
+    }
+
+    return backends;
+}
+
+bool LocalDictionaryBackend::findInAll(const QList<LocalDictionaryBackend *> &backends, const QString &word, QJsonObject *wordData)
+{
+    bool found = false;
+    for (LocalDictionaryBackend *backend : backends) {
+        QJsonObject entry;
+        if (backend->find(word, &entry)) {
+            *wordData = found ? DictionaryBackend::mergeEntries(*wordData, entry) : entry;
+            found = true;
+        }
+    }
+    return found;
+}
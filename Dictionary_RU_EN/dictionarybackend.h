@@ -0,0 +1,56 @@
+#ifndef DICTIONARYBACKEND_H
+#define DICTIONARYBACKEND_H
+
+#include <QObject>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+class QThread;
+
+// A source of dictionary entries.
+// Entries use the layout of OpenRussian's words[0] object
+// ({"translations": [{"tls": [...]}], "sentences": [{"ru": ..., "tl": ...}]})
+// so that every backend renders through the same display and Markdown code.
+class DictionaryBackend : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DictionaryBackend(QObject *parent = nullptr);
+
+    virtual QString name() const = 0;
+    virtual bool isLocal() const = 0;
+
+    // Starts a lookup; the result is reported through lookupFinished()
+    virtual void lookup(const QString &word) = 0;
+
+    // Append translations and sentences of extra to those of entry
+    static QJsonObject mergeEntries(const QJsonObject &entry, const QJsonObject &extra);
+
+signals:
+    void lookupFinished(const QString &word, bool found, const QJsonObject &wordData, const QString &errorString);
+};
+
+// A dictionary stored on this machine. Lookups are answered synchronously.
+class LocalDictionaryBackend : public DictionaryBackend
+{
+    Q_OBJECT
+
+public:
+    explicit LocalDictionaryBackend(QObject *parent = nullptr);
+
+    bool isLocal() const override;
+    void lookup(const QString &word) override;
+
+    virtual bool find(const QString &word, QJsonObject *wordData) = 0;
+
+    // Open every StarDict (.ifo) and DSL (.dsl) dictionary found in directory.
+    // Safe to call from a worker thread: the backends have no parent and are
+    // moved to ownerThread, where the caller can adopt them.
+    static QList<LocalDictionaryBackend *> loadDirectory(const QString &directory, QThread *ownerThread);
+    // Query all backends and merge what they know about word
+    static bool findInAll(const QList<LocalDictionaryBackend *> &backends, const QString &word, QJsonObject *wordData);
+};
+
+#endif // DICTIONARYBACKEND_H
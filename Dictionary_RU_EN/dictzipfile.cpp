@@ -0,0 +1,212 @@
+#include "dictzipfile.h"
+
+#if defined(Q_OS_WIN)
+#include <QtZlib/zlib.h>
+#else
+#include <zlib.h>
+#endif
+
+namespace
+{
+    // gzip header flags (RFC 1952)
+    const int FlagHeaderCrc = 0x02;
+    const int FlagExtra = 0x04;
+    const int FlagName = 0x08;
+    const int FlagComment = 0x10;
+
+    quint16 readLittleEndian16(const uchar *p)
+    {
+        return quint16(p[0] | (p[1] << 8));
+    }
+}
+
+DictZipFile::DictZipFile()
+    : data(nullptr)
+    , dataSize(0)
+    , compressed(false)
+    , chunkLength(0)
+{
+    chunkCache.setMaxCost(8);
+}
+
+DictZipFile::~DictZipFile()
+{
+    close();
+}
+
+bool DictZipFile::open(const QString &filePath)
+{
+    close();
+
+    file.setFileName(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    dataSize = file.size();
+    data = file.map(0, dataSize);
+    if (!data) {
+        close();
+        return false;
+    }
+
+    compressed = dataSize >= 2 && data[0] == 0x1f && data[1] == 0x8b;
+    if (compressed && !parseGzipHeader()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void DictZipFile::close()
+{
+    if (data) {
+        file.unmap(const_cast<uchar *>(data));
+        data = nullptr;
+    }
+    file.close();
+    dataSize = 0;
+    compressed = false;
+    chunkLength = 0;
+    chunkOffsets.clear();
+    chunkCache.clear();
+}
+
+bool DictZipFile::isOpen() const
+{
+    return data != nullptr;
+}
+
+bool DictZipFile::parseGzipHeader()
+{
+    if (dataSize < 10 || data[2] != 8) {
+        return false;
+    }
+
+    int flags = data[3];
+    qint64 pos = 10;
+
+    // Only dictzip files (with the "RA" random access field) can be read randomly
+    if (!(flags & FlagExtra) || pos + 2 > dataSize) {
+        return false;
+    }
+    qint64 extraLength = readLittleEndian16(data + pos);
+    pos += 2;
+    qint64 extraEnd = pos + extraLength;
+    if (extraEnd > dataSize) {
+        return false;
+    }
+
+    QVector<quint16> chunkSizes;
+    while (pos + 4 <= extraEnd) {
+        uchar si1 = data[pos];
+        uchar si2 = data[pos + 1];
+        qint64 fieldLength = readLittleEndian16(data + pos + 2);
+        const uchar *field = data + pos + 4;
+        if (pos + 4 + fieldLength > extraEnd) {
+            return false;
+        }
+
+        if (si1 == 'R' && si2 == 'A' && fieldLength >= 6) {
+            // VER, CHLEN, CHCNT, then CHCNT compressed chunk sizes
+            chunkLength = readLittleEndian16(field + 2);
+            int chunkCount = readLittleEndian16(field + 4);
+            if (fieldLength < 6 + 2 * chunkCount) {
+                return false;
+            }
+            for (int i = 0; i < chunkCount; ++i) {
+                chunkSizes << readLittleEndian16(field + 6 + 2 * i);
+            }
+        }
+        pos += 4 + fieldLength;
+    }
+    pos = extraEnd;
+
+    if (chunkLength == 0 || chunkSizes.isEmpty()) {
+        return false;
+    }
+
+    // Skip the optional file name, comment and header CRC
+    if (flags & FlagName) {
+        while (pos < dataSize && data[pos] != 0) pos++;
+        pos++;
+    }
+    if (flags & FlagComment) {
+        while (pos < dataSize && data[pos] != 0) pos++;
+        pos++;
+    }
+    if (flags & FlagHeaderCrc) {
+        pos += 2;
+    }
+
+    chunkOffsets.reserve(chunkSizes.size() + 1);
+    for (quint16 size : chunkSizes) {
+        chunkOffsets << pos;
+        pos += size;
+    }
+    chunkOffsets << pos;
+
+    return pos <= dataSize;
+}
+
+QByteArray DictZipFile::chunk(int index)
+{
+    if (QByteArray *cached = chunkCache.object(index)) {
+        return *cached;
+    }
+
+    // Each dictzip chunk is a raw deflate stream ending in a full flush
+    z_stream stream = {};
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+        return QByteArray();
+    }
+
+    QByteArray output(chunkLength, Qt::Uninitialized);
+    stream.next_in = const_cast<Bytef *>(data + chunkOffsets[index]);
+    stream.avail_in = uInt(chunkOffsets[index + 1] - chunkOffsets[index]);
+    stream.next_out = reinterpret_cast<Bytef *>(output.data());
+    stream.avail_out = uInt(output.size());
+
+    int result = inflate(&stream, Z_SYNC_FLUSH);
+    int produced = output.size() - int(stream.avail_out);
+    inflateEnd(&stream);
+
+    if (result != Z_OK && result != Z_STREAM_END) {
+        return QByteArray();
+    }
+
+    output.truncate(produced);
+    chunkCache.insert(index, new QByteArray(output));
+    return output;
+}
+
+QByteArray DictZipFile::read(quint64 offset, quint32 size)
+{
+    if (!data || size == 0) {
+        return QByteArray();
+    }
+
+    if (!compressed) {
+        if (offset + size > quint64(dataSize)) {
+            return QByteArray();
+        }
+        return QByteArray(reinterpret_cast<const char *>(data + offset), int(size));
+    }
+
+    int firstChunk = int(offset / quint64(chunkLength));
+    int lastChunk = int((offset + size - 1) / quint64(chunkLength));
+    if (lastChunk >= chunkOffsets.size() - 1) {
+        return QByteArray();
+    }
+
+    QByteArray buffer;
+    for (int i = firstChunk; i <= lastChunk; ++i) {
+        QByteArray inflated = chunk(i);
+        if (inflated.isEmpty()) {
+            return QByteArray();
+        }
+        buffer += inflated;
+    }
+
+    return buffer.mid(int(offset - quint64(firstChunk) * quint64(chunkLength)), int(size));
+}
@@ -0,0 +1,38 @@
+#ifndef DICTZIPFILE_H
+#define DICTZIPFILE_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QFile>
+#include <QVector>
+
+// Random access to a StarDict .dict file, plain or dictzip-compressed (.dict.dz).
+// The file is memory-mapped; for dictzip only the chunks covering a request
+// are inflated, and a few recently used chunks are kept.
+class DictZipFile
+{
+public:
+    DictZipFile();
+    ~DictZipFile();
+
+    bool open(const QString &filePath);
+    void close();
+    bool isOpen() const;
+
+    QByteArray read(quint64 offset, quint32 size);
+
+private:
+    bool parseGzipHeader();
+    QByteArray chunk(int index);
+
+    QFile file;
+    const uchar *data;
+    qint64 dataSize;
+
+    bool compressed;
+    int chunkLength;
+    QVector<qint64> chunkOffsets; // compressed offset of each chunk, plus the end
+    QCache<int, QByteArray> chunkCache;
+};
+
+#endif // DICTZIPFILE_H
@@ -0,0 +1,289 @@
+#include "dslbackend.h"
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QRegularExpression>
+#include <algorithm>
+
+namespace
+{
+    // Reads a headword one character at a time for matching: lowercase,
+    // without the optional {...} parts and escapes, with single spaces.
+    // Works on the mapped bytes so indexing allocates nothing per headword.
+    class KeyReader
+    {
+    public:
+        KeyReader(const uchar *data, qint64 begin, qint64 end, bool utf16)
+            : data(data), pos(begin), end(end), utf16(utf16)
+            , depth(0), started(false), spacePending(false), held(0)
+        {
+        }
+
+        // Next character of the key, 0 at the end
+        uint next()
+        {
+            if (held) {
+                uint c = held;
+                held = 0;
+                return c;
+            }
+            for (;;) {
+                uint c = read();
+                if (!c) return 0;
+                if (c == '{') { ++depth; continue; }
+                if (c == '}' && depth > 0) { --depth; continue; }
+                if (depth > 0) continue;
+
+                if (c == '\\') {
+                    c = read();
+                    if (!c) return 0;
+                } else if (c == ' ' || c == '\t' || c == '\r') {
+                    spacePending = started;
+                    continue;
+                }
+
+                c = QChar::toLower(c);
+                started = true;
+                if (spacePending) {
+                    spacePending = false;
+                    held = c;
+                    return ' ';
+                }
+                return c;
+            }
+        }
+
+    private:
+        uint read()
+        {
+            if (utf16) {
+                if (pos + 2 > end) return 0;
+                uint c = data[pos] | (data[pos + 1] << 8);
+                pos += 2;
+                if (QChar::isHighSurrogate(c) && pos + 2 <= end) {
+                    uint low = data[pos] | (data[pos + 1] << 8);
+                    if (QChar::isLowSurrogate(low)) {
+                        pos += 2;
+                        return QChar::surrogateToUcs4(ushort(c), ushort(low));
+                    }
+                }
+                return c;
+            }
+
+            if (pos >= end) return 0;
+            uint c = data[pos++];
+            if (c < 0x80) return c;
+            if (c < 0xC0) return 0xFFFD;
+            int extra = c >= 0xF0 ? 3 : c >= 0xE0 ? 2 : 1;
+            c &= 0x3F >> extra;
+            while (extra-- > 0 && pos < end && (data[pos] & 0xC0) == 0x80) {
+                c = (c << 6) | (data[pos++] & 0x3F);
+            }
+            return c;
+        }
+
+        const uchar *data;
+        qint64 pos;
+        qint64 end;
+        bool utf16;
+        int depth;
+        bool started;
+        bool spacePending;
+        uint held;
+    };
+
+    int compareKeys(KeyReader a, KeyReader b)
+    {
+        for (;;) {
+            uint x = a.next();
+            uint y = b.next();
+            if (x != y) return x < y ? -1 : 1;
+            if (!x) return 0;
+        }
+    }
+
+    // Strip DSL markup ([m1], [trn], [ex], [/m], ...) from an article line
+    QString plainText(const QString &line)
+    {
+        QString text = line;
+        text.remove(QRegularExpression("\\{\\{[^}]*\\}\\}"));
+        text.remove(QRegularExpression("(?<!\\\\)\\[[^\\]]*\\]"));
+        text.remove('\\');
+        return text.simplified();
+    }
+}
+
+DslBackend::DslBackend(QObject *parent)
+    : LocalDictionaryBackend(parent)
+    , data(nullptr)
+    , dataSize(0)
+    , textStart(0)
+    , utf16(false)
+{
+}
+
+DslBackend::~DslBackend()
+{
+    if (data) {
+        file.unmap(const_cast<uchar *>(data));
+    }
+}
+
+QString DslBackend::name() const
+{
+    return dictionaryName;
+}
+
+bool DslBackend::open(const QString &dslPath)
+{
+    dictionaryName = QFileInfo(dslPath).completeBaseName();
+
+    file.setFileName(dslPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    dataSize = file.size();
+    data = file.map(0, dataSize);
+    if (!data || dataSize < 2) {
+        return false;
+    }
+
+    // Lingvo writes UTF-16LE with a BOM; accept UTF-8 as well
+    if (data[0] == 0xFF && data[1] == 0xFE) {
+        utf16 = true;
+        textStart = 2;
+    } else if (dataSize >= 3 && data[0] == 0xEF && data[1] == 0xBB && data[2] == 0xBF) {
+        textStart = 3;
+    } else {
+        utf16 = data[1] == 0;
+    }
+
+    indexHeadwords();
+    return !headwords.isEmpty();
+}
+
+QString DslBackend::decode(qint64 offset, qint64 length) const
+{
+    if (utf16) {
+        return QString(reinterpret_cast<const QChar *>(data + offset), int(length / 2));
+    }
+    return QString::fromUtf8(reinterpret_cast<const char *>(data + offset), int(length));
+}
+
+void DslBackend::indexHeadwords()
+{
+    const int unit = utf16 ? 2 : 1;
+
+    // Headwords start at column 0, article lines are indented.
+    // Several headword lines may share the article that follows them.
+    QVector<int> waitingForBody;
+    qint64 bodyStart = -1;
+    qint64 pos = textStart;
+
+    auto closeBody = [&](qint64 end) {
+        if (bodyStart < 0) return;
+        for (int index : waitingForBody) {
+            headwords[index].bodyOffset = bodyStart;
+            headwords[index].bodyLength = end - bodyStart;
+        }
+        waitingForBody.clear();
+        bodyStart = -1;
+    };
+
+    while (pos + unit <= dataSize) {
+        // Find the end of the line
+        qint64 end = pos;
+        while (end + unit <= dataSize && !(data[end] == '\n' && (unit == 1 || data[end + 1] == 0))) {
+            end += unit;
+        }
+
+        ushort first = unit == 2 ? ushort(data[pos] | (data[pos + 1] << 8)) : data[pos];
+        bool indented = first == ' ' || first == '\t';
+        bool blank = end == pos || (end - pos == unit && first == '\r');
+
+        if (indented) {
+            if (bodyStart < 0 && !waitingForBody.isEmpty()) {
+                bodyStart = pos;
+            }
+        } else if (!blank && first != '#') {
+            closeBody(pos);
+            if (KeyReader(data, pos, end, utf16).next()) {
+                Headword entry;
+                entry.offset = pos;
+                entry.length = end - pos;
+                entry.bodyOffset = 0;
+                entry.bodyLength = 0;
+                waitingForBody << headwords.size();
+                headwords << entry;
+            }
+        }
+
+        pos = end + unit;
+    }
+    closeBody(dataSize);
+
+    std::sort(headwords.begin(), headwords.end(), [this](const Headword &a, const Headword &b) {
+        return compareKeys(KeyReader(data, a.offset, a.offset + a.length, utf16),
+                           KeyReader(data, b.offset, b.offset + b.length, utf16)) < 0;
+    });
+}
+
+int DslBackend::compareHeadword(const Headword &headword, const QVector<uint> &key) const
+{
+    KeyReader reader(data, headword.offset, headword.offset + headword.length, utf16);
+    for (uint k : key) {
+        uint c = reader.next();
+        if (c != k) return c < k ? -1 : 1;
+    }
+    return reader.next() ? 1 : 0;
+}
+
+bool DslBackend::find(const QString &word, QJsonObject *wordData)
+{
+    // The query goes through the same normalization as the headwords
+    QVector<uint> key;
+    KeyReader reader(reinterpret_cast<const uchar *>(word.utf16()), 0, qint64(word.size()) * 2, true);
+    for (uint c = reader.next(); c; c = reader.next()) {
+        key << c;
+    }
+    if (key.isEmpty()) {
+        return false;
+    }
+
+    QJsonArray translations = (*wordData)["translations"].toArray();
+    QJsonArray sentences = (*wordData)["sentences"].toArray();
+
+    auto it = std::lower_bound(headwords.constBegin(), headwords.constEnd(), key, [this](const Headword &headword, const QVector<uint> &key) {
+        return compareHeadword(headword, key) < 0;
+    });
+    for (; it != headwords.constEnd() && compareHeadword(*it, key) == 0; ++it) {
+        if (it->bodyLength <= 0) continue;
+
+        const QStringList lines = decode(it->bodyOffset, it->bodyLength).split('\n');
+        for (const QString &line : lines) {
+            QString text = plainText(line);
+            if (text.isEmpty()) continue;
+
+            if (line.contains("[ex]")) {
+                // Examples are usually "Russian — English"
+                QStringList parts = text.split(QRegularExpression("\\s[—–-]\\s"));
+                QJsonObject sentence;
+                sentence["ru"] = parts.value(0);
+                sentence["tl"] = parts.mid(1).join(" - ");
+                sentences.append(sentence);
+            } else {
+                QJsonObject translation;
+                translation["tls"] = QJsonArray() << text;
+                translation["source"] = dictionaryName;
+                translations.append(translation);
+            }
+        }
+    }
+
+    if (translations.isEmpty()) {
+        return false;
+    }
+
+    (*wordData)["translations"] = translations;
+    (*wordData)["sentences"] = sentences;
+    return true;
+}
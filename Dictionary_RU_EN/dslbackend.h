@@ -0,0 +1,47 @@
+#ifndef DSLBACKEND_H
+#define DSLBACKEND_H
+
+#include "dictionarybackend.h"
+#include <QFile>
+#include <QVector>
+
+// Offline ABBYY Lingvo DSL dictionary (UTF-16LE or UTF-8 .dsl).
+// The file is memory-mapped; opening builds a table of headword and article
+// byte offsets sorted by the normalized headword. Keys are compared directly
+// against the mapped bytes, and articles are decoded only when looked up.
+class DslBackend : public LocalDictionaryBackend
+{
+    Q_OBJECT
+
+public:
+    explicit DslBackend(QObject *parent = nullptr);
+    ~DslBackend();
+
+    bool open(const QString &dslPath);
+
+    QString name() const override;
+    bool find(const QString &word, QJsonObject *wordData) override;
+
+private:
+    struct Headword
+    {
+        qint64 offset;
+        qint64 length;
+        qint64 bodyOffset;
+        qint64 bodyLength;
+    };
+
+    QString decode(qint64 offset, qint64 length) const;
+    int compareHeadword(const Headword &headword, const QVector<uint> &key) const;
+    void indexHeadwords();
+
+    QString dictionaryName;
+    QFile file;
+    const uchar *data;
+    qint64 dataSize;
+    qint64 textStart;
+    bool utf16;
+    QVector<Headword> headwords;
+};
+
+#endif // DSLBACKEND_H
@@ -0,0 +1,167 @@
+#include "entrycache.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QFile>
+#include <QJsonDocument>
+#include <QRegularExpression>
+#include <QSaveFile>
+
+EntryCache::EntryCache(const QString &directory, QObject *parent)
+    : QObject(parent)
+    , cacheDirectory(directory)
+    , writesHeld(false)
+{
+    // Keep the most recent entries parsed in memory, the rest stay on disk
+    memoryCache.setMaxCost(2000);
+
+    QDir cacheDir(cacheDirectory);
+    if (!cacheDir.exists()) {
+        cacheDir.mkpath(".");
+    }
+}
+
+QString EntryCache::directory() const
+{
+    return cacheDirectory;
+}
+
+QString EntryCache::safeFileName(const QString &word)
+{
+    QString safeWord = word;
+    safeWord.replace(QRegularExpression("[^a-zA-Z0-9а-яА-ЯёЁ]"), "_");
+    return safeWord;
+}
+
+QString EntryCache::normalizeWord(const QString &word)
+{
+    // "Дом", "дом" and "до́м" are the same entry
+    QString normalized = word.trimmed().toLower();
+    normalized.remove(QChar(0x0301));
+    normalized.remove(QChar(0x0300));
+    return normalized;
+}
+
+QString EntryCache::filePathForWord(const QString &word) const
+{
+    return QString("%1/%2.json").arg(cacheDirectory, safeFileName(normalizeWord(word)));
+}
+
+bool EntryCache::contains(const QString &word) const
+{
+    QString key = normalizeWord(word);
+    return memoryCache.contains(key) || heldWrites.contains(key) || QFile::exists(filePathForWord(word));
+}
+
+bool EntryCache::lookup(const QString &word, QJsonObject *wordData)
+{
+    QString key = normalizeWord(word);
+    if (QJsonObject *cached = memoryCache.object(key)) {
+        *wordData = *cached;
+        return true;
+    }
+    if (heldWrites.contains(key)) {
+        *wordData = heldWrites.value(key).second;
+        return true;
+    }
+
+    if (!readEntry(cacheDirectory, word, wordData)) {
+        return false;
+    }
+
+    memoryCache.insert(key, new QJsonObject(*wordData));
+    return true;
+}
+
+bool EntryCache::readEntry(const QString &directory, const QString &word, QJsonObject *wordData)
+{
+    QFile file(QString("%1/%2.json").arg(directory, safeFileName(normalizeWord(word))));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    if (!doc.isObject()) {
+        return false;
+    }
+
+    *wordData = doc.object();
+    return true;
+}
+
+void EntryCache::store(const QString &word, const QJsonObject &wordData)
+{
+    QString key = normalizeWord(word);
+    memoryCache.insert(key, new QJsonObject(wordData));
+
+    if (writesHeld) {
+        heldWrites.insert(key, qMakePair(word, wordData));
+    } else {
+        writeEntry(word, wordData);
+    }
+
+    emit entryStored(word, wordData);
+}
+
+void EntryCache::setWritesHeld(bool held)
+{
+    writesHeld = held;
+    if (held) return;
+
+    for (const QPair<QString, QJsonObject> &entry : heldWrites) {
+        writeEntry(entry.first, entry.second);
+    }
+    heldWrites.clear();
+}
+
+void EntryCache::writeEntry(const QString &word, const QJsonObject &wordData)
+{
+    // File names are lossy, so the headword is saved along with the entry
+    QJsonObject saved = wordData;
+    saved["headword"] = word;
+
+    // Write atomically so a crash never leaves a truncated entry behind
+    QSaveFile file(filePathForWord(word));
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(saved).toJson(QJsonDocument::Compact));
+        file.commit();
+    }
+}
+
+void EntryCache::reloadFile(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return;
+
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    if (!doc.isObject()) return;
+
+    QJsonObject wordData = doc.object();
+    QString word = wordData["headword"].toString();
+    if (word.isEmpty()) {
+        word = QFileInfo(filePath).completeBaseName();
+    }
+
+    memoryCache.remove(normalizeWord(word));
+    emit entryStored(word, wordData);
+}
+
+void EntryCache::readDirectory(const QString &directory,
+                               const std::function<void(const QString &, const QJsonObject &)> &callback)
+{
+    QDirIterator it(directory, QStringList() << "*.json", QDir::Files);
+    while (it.hasNext()) {
+        QFile file(it.next());
+        if (!file.open(QIODevice::ReadOnly)) continue;
+
+        QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+        if (!doc.isObject()) continue;
+
+        QJsonObject wordData = doc.object();
+        QString word = wordData["headword"].toString();
+        if (word.isEmpty()) {
+            word = QFileInfo(file.fileName()).completeBaseName();
+        }
+        callback(word, wordData);
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef ENTRYCACHE_H
+#define ENTRYCACHE_H
+
+#include <QObject>
+#include <QCache>
+#include <QHash>
+#include <QJsonObject>
+#include <QPair>
+#include <QString>
+#include <functional>
+
+// Dictionary entries (words[0] of an OpenRussian page) cached in memory and
+// on disk, one JSON file per word, next to the word_audio folder.
+class EntryCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit EntryCache(const QString &directory, QObject *parent = nullptr);
+
+    QString directory() const;
+    bool contains(const QString &word) const;
+    bool lookup(const QString &word, QJsonObject *wordData);
+    void store(const QString &word, const QJsonObject &wordData);
+    // While held (a sync is rewriting the directory), stored entries are kept
+    // in memory only and written to disk when released
+    void setWritesHeld(bool held);
+    // An entry file written behind the cache's back (a sync import): forget the
+    // memory copy and announce the entry through entryStored()
+    void reloadFile(const QString &filePath);
+
+    static QString safeFileName(const QString &word);
+    // Key an entry is stored under: lowercase, without stress marks
+    static QString normalizeWord(const QString &word);
+
+    // Read one entry from directory, bypassing the memory cache; safe to call from a worker thread
+    static bool readEntry(const QString &directory, const QString &word, QJsonObject *wordData);
+
+    // Read every entry stored in directory; safe to call from a worker thread
+    static void readDirectory(const QString &directory,
+                              const std::function<void(const QString &word, const QJsonObject &wordData)> &callback);
+
+signals:
+    void entryStored(const QString &word, const QJsonObject &wordData);
+
+private:
+    QString filePathForWord(const QString &word) const;
+    void writeEntry(const QString &word, const QJsonObject &wordData);
+
+    QString cacheDirectory;
+    QCache<QString, QJsonObject> memoryCache;
+    bool writesHeld;
+    QHash<QString, QPair<QString, QJsonObject>> heldWrites;
+};
+
+#endif // ENTRYCACHE_H
@@ -0,0 +1,281 @@
+#include "historyexporter.h"
+#include "entrycache.h"
+#include "openrussian.h"
+#include "texttospeech.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QQueue>
+#include <QTextStream>
+#include <QThread>
+#include <QtConcurrent>
+
+namespace
+{
+    const int BatchSize = 256;
+    const char *TimestampFormat = "yyyy-MM-dd hh:mm:ss";
+
+    // Plain text of a saved definition, keeping list items and line breaks
+    QString htmlToText(QString html)
+    {
+        html.replace(QRegularExpression("<br\\s*/?>|</li>|</h\\d>|</p>", QRegularExpression::CaseInsensitiveOption), "\n");
+        html.replace(QRegularExpression("<li>", QRegularExpression::CaseInsensitiveOption), "* ");
+        html.remove(QRegularExpression("<[^>]*>"));
+        html.replace("&nbsp;", " ");
+        html.replace("&#x27;", "'");
+        html.replace("&quot;", "\"");
+        html.replace("&lt;", "<");
+        html.replace("&gt;", ">");
+        html.replace("&amp;", "&");
+        return html.trimmed();
+    }
+
+    // Quote a field if it contains the separator, a quote or a line break (RFC 4180)
+    QString quoteField(const QString &field, QChar separator)
+    {
+        if (!field.contains(separator) && !field.contains('"') && !field.contains('\n') && !field.contains('\r')) {
+            return field;
+        }
+        QString quoted = field;
+        quoted.replace("\"", "\"\"");
+        return "\"" + quoted + "\"";
+    }
+
+    // Pronunciation downloaded for the word, if any
+    QString audioFile(const QString &word)
+    {
+        QString path = TextToSpeech::localFilePath(word, "ru");
+        return QFile::exists(path) ? path : QString();
+    }
+}
+
+HistoryExporter::HistoryExporter(const QString &historyFile, const QString &entryCacheDirectory, QObject *parent)
+    : QObject(parent)
+    , historyFile(historyFile)
+    , entryCacheDirectory(entryCacheDirectory)
+    , format(Markdown)
+    , exported(0)
+{
+}
+
+bool HistoryExporter::formatFromName(const QString &name, Format *format)
+{
+    QString lower = name.toLower();
+    if (lower == "markdown" || lower == "md") *format = Markdown;
+    else if (lower == "jsonl" || lower == "json") *format = JsonLines;
+    else if (lower == "csv") *format = Csv;
+    else if (lower == "anki" || lower == "tsv") *format = AnkiTsv;
+    else return false;
+    return true;
+}
+
+HistoryExporter::Format HistoryExporter::formatForFileName(const QString &fileName)
+{
+    QString suffix = QFileInfo(fileName).suffix().toLower();
+    Format format = Markdown;
+    if (suffix == "txt") return AnkiTsv;
+    formatFromName(suffix, &format);
+    return format;
+}
+
+void HistoryExporter::setFormat(Format format)
+{
+    this->format = format;
+}
+
+void HistoryExporter::setSince(const QDateTime &since)
+{
+    this->since = since.isValid() ? since.toString(TimestampFormat) : QString();
+}
+
+void HistoryExporter::setUntil(const QDateTime &until)
+{
+    this->until = until.isValid() ? until.toString(TimestampFormat) : QString();
+}
+
+void HistoryExporter::setWordFilter(const QRegularExpression &filter)
+{
+    wordFilter = filter;
+}
+
+int HistoryExporter::exportedCount() const
+{
+    return exported;
+}
+
+QString HistoryExporter::errorString() const
+{
+    return error;
+}
+
+bool HistoryExporter::parseLine(const QString &line, Record *record)
+{
+    // The definition is HTML and may itself contain '|', so split at the outer separators only
+    int first = line.indexOf('|');
+    int second = first < 0 ? -1 : line.indexOf('|', first + 1);
+    int last = line.lastIndexOf('|');
+    if (second < 0 || last <= second) return false;
+
+    record->timestamp = line.left(first);
+    record->word = line.mid(first + 1, second - first - 1);
+    record->definition = line.mid(second + 1, last - second - 1);
+    record->summary = line.mid(last + 1);
+    return true;
+}
+
+bool HistoryExporter::accepts(const Record &record) const
+{
+    // Timestamps are "yyyy-MM-dd hh:mm:ss", so string order is time order
+    if (!since.isEmpty() && record.timestamp < since) return false;
+    if (!until.isEmpty() && record.timestamp > until) return false;
+    if (!wordFilter.pattern().isEmpty() && !wordFilter.match(record.word).hasMatch()) return false;
+    return true;
+}
+
+QByteArray HistoryExporter::header(Format format)
+{
+    switch (format) {
+    case Csv:
+        return "timestamp,word,translation,summary,audio\r\n";
+    case AnkiTsv:
+        // File headers understood by Anki's text importer
+        return "#separator:tab\n#html:true\n#columns:Russian\tEnglish\tAudio\n";
+    default:
+        return QByteArray();
+    }
+}
+
+QByteArray HistoryExporter::renderBatch(Format format, const QVector<Record> &records, const QString &entryCacheDirectory)
+{
+    QByteArray output;
+
+    for (const Record &record : records) {
+        // The cached entry is richer than the saved HTML, use it when available
+        QJsonObject wordData;
+        bool cached = EntryCache::readEntry(entryCacheDirectory, record.word, &wordData);
+
+        switch (format) {
+        case Markdown: {
+            QString markdown = cached ? OpenRussian::formatMarkdown(record.word, wordData)
+                                      : QString("# <font color='red'>%1</font>\n\n%2\n\n").arg(record.word, htmlToText(record.definition));
+            markdown += QString("*Looked up %1*\n\n---\n\n").arg(record.timestamp);
+            output += markdown.toUtf8();
+            break;
+        }
+        case JsonLines: {
+            QJsonObject object;
+            object["timestamp"] = record.timestamp;
+            object["word"] = record.word;
+            object["summary"] = record.summary;
+            object["definition"] = record.definition;
+            if (cached) {
+                object["translations"] = wordData["translations"];
+                object["sentences"] = wordData["sentences"];
+            }
+            QString audio = audioFile(record.word);
+            if (!audio.isEmpty()) object["audio"] = audio;
+            output += QJsonDocument(object).toJson(QJsonDocument::Compact);
+            output += '\n';
+            break;
+        }
+        case Csv: {
+            QStringList fields;
+            fields << record.timestamp << record.word
+                   << (cached ? OpenRussian::firstTranslation(wordData) : QString())
+                   << record.summary.simplified() << audioFile(record.word);
+            for (QString &field : fields) field = quoteField(field, ',');
+            output += fields.join(',').toUtf8();
+            output += "\r\n";
+            break;
+        }
+        case AnkiTsv: {
+            // Anki looks up [sound:] files in its collection.media folder
+            QString audio = audioFile(record.word);
+            QString sound = audio.isEmpty() ? QString() : QString("[sound:%1]").arg(QFileInfo(audio).fileName());
+            QString back = record.definition;
+            back.replace('\t', ' ');
+            QStringList fields;
+            fields << quoteField(record.word, '\t') << quoteField(back, '\t') << sound;
+            output += fields.join('\t').toUtf8();
+            output += '\n';
+            break;
+        }
+        }
+    }
+
+    return output;
+}
+
+bool HistoryExporter::exportTo(const QString &outputPath)
+{
+    exported = 0;
+    error.clear();
+
+    QFile input(historyFile);
+    if (!input.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        error = QString("Cannot read %1: %2").arg(historyFile, input.errorString());
+        return false;
+    }
+
+    QFile output;
+    bool opened;
+    if (outputPath == "-") {
+        opened = output.open(stdout, QIODevice::WriteOnly);
+    } else {
+        output.setFileName(outputPath);
+        opened = output.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    }
+    if (!opened) {
+        error = QString("Cannot write %1: %2").arg(outputPath, output.errorString());
+        return false;
+    }
+
+    output.write(header(format));
+
+    // Same decoding the history was written with
+    QTextStream stream(&input);
+    QVector<Record> batch;
+    batch.reserve(BatchSize);
+
+    // Rendered batches in file order; the oldest one is written before a new one is queued
+    const int maxPending = qMax(2, QThread::idealThreadCount() * 2);
+    // Each batch remembers how far into the history file it was read
+    QQueue<QPair<QFuture<QByteArray>, qint64>> pending;
+    const qint64 inputSize = input.size();
+    bool writeFailed = false;
+
+    auto writeOldest = [&]() {
+        QPair<QFuture<QByteArray>, qint64> oldest = pending.dequeue();
+        QByteArray data = oldest.first.result();
+        if (!writeFailed && output.write(data) != data.size()) {
+            writeFailed = true;
+        }
+        emit progress(oldest.second, inputSize);
+    };
+    auto enqueue = [&]() {
+        if (pending.size() >= maxPending) writeOldest();
+        pending.enqueue(qMakePair(QtConcurrent::run(&HistoryExporter::renderBatch, format, batch, entryCacheDirectory), input.pos()));
+        batch.clear();
+    };
+
+    while (!stream.atEnd()) {
+        Record record;
+        if (!parseLine(stream.readLine(), &record) || !accepts(record)) continue;
+
+        batch.append(record);
+        exported++;
+        if (batch.size() == BatchSize) enqueue();
+    }
+    if (!batch.isEmpty()) enqueue();
+    while (!pending.isEmpty()) {
+        writeOldest();
+    }
+
+    if (writeFailed || !output.flush()) {
+        error = QString("Cannot write %1: %2").arg(outputPath, output.errorString());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,80 @@
+#ifndef HISTORYEXPORTER_H
+#define HISTORYEXPORTER_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QObject>
+#include <QRegularExpression>
+#include <QString>
+#include <QVector>
+
+// Exports the lookup history (timestamp|word|definition html|summary lines)
+// to Markdown, JSON Lines, CSV or an Anki-importable TSV.
+//
+// The history file is streamed in batches: each batch is rendered on the thread
+// pool and the rendered batches are written in their original order. Only a few
+// batches are alive at any time, so memory use does not depend on the history size.
+class HistoryExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Format
+    {
+        Markdown,
+        JsonLines,
+        Csv,
+        AnkiTsv
+    };
+
+    struct Record
+    {
+        QString timestamp;
+        QString word;
+        QString definition;
+        QString summary;
+    };
+
+    HistoryExporter(const QString &historyFile, const QString &entryCacheDirectory, QObject *parent = nullptr);
+
+    // "markdown"/"md", "jsonl", "csv", "anki"/"tsv"
+    static bool formatFromName(const QString &name, Format *format);
+    // Guess the format from the file extension, Markdown if unknown
+    static Format formatForFileName(const QString &fileName);
+
+    void setFormat(Format format);
+    // Only export records in [since, until] whose word matches the filter; null/empty means no limit
+    void setSince(const QDateTime &since);
+    void setUntil(const QDateTime &until);
+    void setWordFilter(const QRegularExpression &filter);
+
+    // Write the export to outputPath ("-" for stdout); blocks until done.
+    // May run on a worker thread; progress() is then delivered queued.
+    bool exportTo(const QString &outputPath);
+
+    int exportedCount() const;
+    QString errorString() const;
+
+signals:
+    // How much of the history file has been exported so far
+    void progress(qint64 bytesRead, qint64 totalBytes);
+
+private:
+    bool accepts(const Record &record) const;
+
+    static bool parseLine(const QString &line, Record *record);
+    static QByteArray header(Format format);
+    static QByteArray renderBatch(Format format, const QVector<Record> &records, const QString &entryCacheDirectory);
+
+    QString historyFile;
+    QString entryCacheDirectory;
+    Format format;
+    QString since;
+    QString until;
+    QRegularExpression wordFilter;
+
+    int exported;
+    QString error;
+};
+
+#endif // HISTORYEXPORTER_H
@@ -0,0 +1,452 @@
+#include "lazyjson.h"
+#include <QJsonArray>
+#include <QJsonObject>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LAZYJSON_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define LAZYJSON_NEON
+#endif
+
+namespace
+{
+    inline bool isWhitespace(char c)
+    {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+#if defined(LAZYJSON_SSE2) || defined(LAZYJSON_NEON)
+    // Whether the 16 bytes at p contain anything the scan has to look at: a quote or
+    // backslash, and outside strings also a bracket, colon or comma
+    inline bool blockNeedsScan(const char *p, bool inString)
+    {
+#ifdef LAZYJSON_SSE2
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        __m128i found = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('"')),
+                                     _mm_cmpeq_epi8(block, _mm_set1_epi8('\\')));
+        if (!inString) {
+            // '[' and ']' are '{' and '}' without the 0x20 bit
+            __m128i folded = _mm_or_si128(block, _mm_set1_epi8(0x20));
+            found = _mm_or_si128(found, _mm_cmpeq_epi8(folded, _mm_set1_epi8('{')));
+            found = _mm_or_si128(found, _mm_cmpeq_epi8(folded, _mm_set1_epi8('}')));
+            found = _mm_or_si128(found, _mm_cmpeq_epi8(block, _mm_set1_epi8(':')));
+            found = _mm_or_si128(found, _mm_cmpeq_epi8(block, _mm_set1_epi8(',')));
+        }
+        return _mm_movemask_epi8(found) != 0;
+#else
+        uint8x16_t block = vld1q_u8(reinterpret_cast<const uint8_t *>(p));
+        uint8x16_t found = vorrq_u8(vceqq_u8(block, vdupq_n_u8('"')), vceqq_u8(block, vdupq_n_u8('\\')));
+        if (!inString) {
+            uint8x16_t folded = vorrq_u8(block, vdupq_n_u8(0x20));
+            found = vorrq_u8(found, vceqq_u8(folded, vdupq_n_u8('{')));
+            found = vorrq_u8(found, vceqq_u8(folded, vdupq_n_u8('}')));
+            found = vorrq_u8(found, vceqq_u8(block, vdupq_n_u8(':')));
+            found = vorrq_u8(found, vceqq_u8(block, vdupq_n_u8(',')));
+        }
+        return vmaxvq_u8(found) != 0;
+#endif
+    }
+#endif
+
+    inline bool isDigit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    // A number, true, false or null, with no surrounding whitespace
+    bool isScalar(const char *p, int length)
+    {
+        if ((length == 4 && memcmp(p, "true", 4) == 0) || (length == 4 && memcmp(p, "null", 4) == 0)
+            || (length == 5 && memcmp(p, "false", 5) == 0)) {
+            return true;
+        }
+
+        // -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+        int i = 0;
+        if (i < length && p[i] == '-') i++;
+        if (i >= length || !isDigit(p[i])) return false;
+        if (p[i] == '0') {
+            i++;
+        } else {
+            while (i < length && isDigit(p[i])) i++;
+        }
+        if (i < length && p[i] == '.') {
+            if (++i >= length || !isDigit(p[i])) return false;
+            while (i < length && isDigit(p[i])) i++;
+        }
+        if (i < length && (p[i] == 'e' || p[i] == 'E')) {
+            i++;
+            if (i < length && (p[i] == '+' || p[i] == '-')) i++;
+            if (i >= length || !isDigit(p[i])) return false;
+            while (i < length && isDigit(p[i])) i++;
+        }
+        return i == length;
+    }
+}
+
+LazyJson::LazyJson(const char *data, int size)
+    : data(data)
+    , size(size)
+    , valid(false)
+{
+    scan();
+}
+
+bool LazyJson::isValid() const
+{
+    return valid;
+}
+
+void LazyJson::scan()
+{
+    // Roughly one structural character per 8 bytes in typical page data
+    positions.reserve(size / 8 + 16);
+    partners.reserve(size / 8 + 16);
+
+    QVector<int> openBrackets;
+    bool inString = false;
+    int i = 0;
+
+    while (i < size) {
+#if defined(LAZYJSON_SSE2) || defined(LAZYJSON_NEON)
+        // Long runs of string content (and whitespace or literals) are skipped a block at a time
+        if ((i & 15) == 0 && i + 16 <= size && !blockNeedsScan(data + i, inString)) {
+            i += 16;
+            continue;
+        }
+#endif
+        char c = data[i];
+
+        if (inString) {
+            if (c == '\\') {
+                i += 2;
+                continue;
+            }
+            if (c == '"') {
+                inString = false;
+                positions.append(quint32(i));
+                partners.append(0);
+            }
+            i++;
+            continue;
+        }
+
+        switch (c) {
+        case '"':
+            inString = true;
+            positions.append(quint32(i));
+            partners.append(0);
+            break;
+        case '{':
+        case '[':
+            openBrackets.append(positions.size());
+            positions.append(quint32(i));
+            partners.append(0);
+            break;
+        case '}':
+        case ']': {
+            if (openBrackets.isEmpty()) return;
+            int open = openBrackets.takeLast();
+            if (data[positions[open]] != (c == '}' ? '{' : '[')) return;
+            partners[open] = quint32(positions.size());
+            partners.append(quint32(open));
+            positions.append(quint32(i));
+            break;
+        }
+        case ':':
+        case ',':
+            positions.append(quint32(i));
+            partners.append(0);
+            break;
+        default:
+            break;
+        }
+        i++;
+    }
+
+    valid = !inString && openBrackets.isEmpty() && checkGrammar();
+}
+
+bool LazyJson::checkGrammar() const
+{
+    // What may come next at the current nesting level
+    enum Expect { Value, ValueOrClose, Key, KeyOrClose, Colon, CommaOrClose, End };
+
+    QVector<char> containers;
+    Expect expect = Value;
+    int gapBegin = 0;
+
+    auto afterValue = [&containers]() { return containers.isEmpty() ? End : CommaOrClose; };
+
+    // Numbers and literals are whatever non-whitespace lies between two structural characters
+    auto checkGap = [&](int gapEnd) {
+        int begin = gapBegin;
+        int end = gapEnd;
+        while (begin < end && isWhitespace(data[begin])) begin++;
+        while (end > begin && isWhitespace(data[end - 1])) end--;
+        if (begin == end) return true;
+        if ((expect != Value && expect != ValueOrClose) || !isScalar(data + begin, end - begin)) return false;
+        expect = afterValue();
+        return true;
+    };
+
+    const int count = positions.size();
+    for (int token = 0; token < count; ++token) {
+        int pos = int(positions[token]);
+        if (!checkGap(pos)) return false;
+        gapBegin = pos + 1;
+
+        switch (data[pos]) {
+        case '"':
+            // The closing quote is always the next token
+            gapBegin = int(positions[++token]) + 1;
+            if (expect == Key || expect == KeyOrClose) expect = Colon;
+            else if (expect == Value || expect == ValueOrClose) expect = afterValue();
+            else return false;
+            break;
+        case '{':
+        case '[':
+            if (expect != Value && expect != ValueOrClose) return false;
+            containers.append(data[pos]);
+            expect = data[pos] == '{' ? KeyOrClose : ValueOrClose;
+            break;
+        case '}':
+        case ']':
+            // Bracket pairing was checked by the scan
+            if (expect != CommaOrClose && expect != (data[pos] == '}' ? KeyOrClose : ValueOrClose)) return false;
+            containers.removeLast();
+            expect = afterValue();
+            break;
+        case ':':
+            if (expect != Colon) return false;
+            expect = Value;
+            break;
+        case ',':
+            if (expect != CommaOrClose) return false;
+            expect = containers.last() == '{' ? Key : Value;
+            break;
+        }
+    }
+
+    return checkGap(size) && expect == End;
+}
+
+char LazyJson::charAt(int token) const
+{
+    return token >= 0 && token < positions.size() ? data[positions[token]] : '\0';
+}
+
+LazyJson::Value LazyJson::root() const
+{
+    return valid ? valueAfter(-1) : Value();
+}
+
+LazyJson::Value LazyJson::valueAfter(int separator) const
+{
+    int begin = separator < 0 ? 0 : int(positions[separator]) + 1;
+    while (begin < size && isWhitespace(data[begin])) begin++;
+
+    int token = separator + 1;
+    if (token < positions.size() && int(positions[token]) == begin) {
+        switch (data[begin]) {
+        case '"':
+            return Value(this, token, begin, int(positions[token + 1]) + 1, token + 2);
+        case '{':
+        case '[': {
+            int close = int(partners[token]);
+            return Value(this, token, begin, int(positions[close]) + 1, close + 1);
+        }
+        default:
+            // A separator or closing bracket: there is no value here, e.g. "[]"
+            return Value();
+        }
+    }
+
+    // Number, boolean or null: everything up to the next structural character
+    int end = token < positions.size() ? int(positions[token]) : size;
+    while (end > begin && isWhitespace(data[end - 1])) end--;
+    if (end <= begin) return Value();
+    return Value(this, -1, begin, end, token);
+}
+
+QString LazyJson::decodeString(int begin, int end) const
+{
+    const char *start = data + begin;
+    const char *escape = static_cast<const char *>(memchr(start, '\\', size_t(end - begin)));
+    if (!escape) {
+        return QString::fromUtf8(start, end - begin);
+    }
+
+    QString result;
+    result.reserve(end - begin);
+    int i = begin;
+    while (i < end) {
+        int run = i;
+        while (run < end && data[run] != '\\') run++;
+        result += QString::fromUtf8(data + i, run - i);
+        if (run + 1 >= end) break;
+
+        char c = data[run + 1];
+        i = run + 2;
+        switch (c) {
+        case 'b': result += QChar('\b'); break;
+        case 'f': result += QChar('\f'); break;
+        case 'n': result += QChar('\n'); break;
+        case 'r': result += QChar('\r'); break;
+        case 't': result += QChar('\t'); break;
+        case 'u':
+            if (i + 4 <= end) {
+                // UTF-16 code unit; surrogate pairs come as two escapes and combine in the QString
+                bool ok = false;
+                ushort unit = QByteArray::fromRawData(data + i, 4).toUShort(&ok, 16);
+                if (ok) result += QChar(unit);
+                i += 4;
+            }
+            break;
+        default:
+            result += QChar::fromLatin1(c);  // \" \\ \/
+            break;
+        }
+    }
+    return result;
+}
+
+LazyJson::Value::Value()
+    : json(nullptr)
+    , token(-1)
+    , begin(0)
+    , end(0)
+    , nextToken(-1)
+{
+}
+
+LazyJson::Value::Value(const LazyJson *json, int token, int begin, int end, int nextToken)
+    : json(json)
+    , token(token)
+    , begin(begin)
+    , end(end)
+    , nextToken(nextToken)
+{
+}
+
+char LazyJson::Value::firstChar() const
+{
+    return json ? json->data[begin] : '\0';
+}
+
+bool LazyJson::Value::isValid() const
+{
+    return json != nullptr;
+}
+
+bool LazyJson::Value::isObject() const
+{
+    return firstChar() == '{';
+}
+
+bool LazyJson::Value::isArray() const
+{
+    return firstChar() == '[';
+}
+
+bool LazyJson::Value::isString() const
+{
+    return firstChar() == '"';
+}
+
+LazyJson::Value LazyJson::Value::operator[](const char *key) const
+{
+    if (!isObject()) return Value();
+
+    const size_t keyLength = strlen(key);
+    int member = token + 1;
+    while (json->charAt(member) == '"' && json->charAt(member + 2) == ':') {
+        int keyBegin = int(json->positions[member]) + 1;
+        int keyEnd = int(json->positions[member + 1]);
+
+        Value value = json->valueAfter(member + 2);
+        if (!value.isValid()) return Value();
+
+        // Keys with escapes are rare enough to be decoded for the comparison
+        const char *rawKey = json->data + keyBegin;
+        if ((size_t(keyEnd - keyBegin) == keyLength && memcmp(rawKey, key, keyLength) == 0)
+            || (memchr(rawKey, '\\', size_t(keyEnd - keyBegin)) && json->decodeString(keyBegin, keyEnd) == QLatin1String(key))) {
+            return value;
+        }
+
+        if (json->charAt(value.nextToken) != ',') break;
+        member = value.nextToken + 1;
+    }
+    return Value();
+}
+
+LazyJson::Value LazyJson::Value::operator[](int index) const
+{
+    Value element = first();
+    for (int i = 0; i < index && element.isValid(); ++i) {
+        element = element.next();
+    }
+    return element;
+}
+
+LazyJson::Value LazyJson::Value::first() const
+{
+    return isArray() ? json->valueAfter(token) : Value();
+}
+
+LazyJson::Value LazyJson::Value::next() const
+{
+    if (!json || json->charAt(nextToken) != ',') return Value();
+    return json->valueAfter(nextToken);
+}
+
+QString LazyJson::Value::toString() const
+{
+    return isString() ? json->decodeString(begin + 1, end - 1) : QString();
+}
+
+double LazyJson::Value::toDouble() const
+{
+    if (!json || token >= 0) return 0;
+    return QByteArray::fromRawData(json->data + begin, end - begin).toDouble();
+}
+
+QJsonValue LazyJson::Value::toJsonValue() const
+{
+    if (!json) return QJsonValue(QJsonValue::Undefined);
+
+    switch (firstChar()) {
+    case '"':
+        return toString();
+    case '[': {
+        QJsonArray array;
+        for (Value element = first(); element.isValid(); element = element.next()) {
+            array.append(element.toJsonValue());
+        }
+        return array;
+    }
+    case '{': {
+        QJsonObject object;
+        int member = token + 1;
+        while (json->charAt(member) == '"' && json->charAt(member + 2) == ':') {
+            Value value = json->valueAfter(member + 2);
+            if (!value.isValid()) break;
+            object.insert(json->decodeString(int(json->positions[member]) + 1, int(json->positions[member + 1])), value.toJsonValue());
+            if (json->charAt(value.nextToken) != ',') break;
+            member = value.nextToken + 1;
+        }
+        return object;
+    }
+    case 't':
+        return true;
+    case 'f':
+        return false;
+    case 'n':
+        return QJsonValue(QJsonValue::Null);
+    default:
+        return toDouble();
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef LAZYJSON_H
+#define LAZYJSON_H
+
+#include <QJsonValue>
+#include <QString>
+#include <QVector>
+
+// Read-only view of a JSON text that decodes values only when they are read.
+//
+// The constructor makes one structural pass over the text, 16 bytes at a time
+// with SSE2/NEON where available, recording the offset of every bracket, colon,
+// comma and string quote and pairing up the brackets. Navigation then jumps over
+// whole objects, arrays and strings without looking inside them; no node is built
+// per value, and only the strings that are asked for get decoded.
+// A second pass over the recorded offsets checks the grammar, so malformed text
+// such as {"a" "b"} or [1 2] is rejected up front.
+// The text is not copied and must outlive the reader.
+class LazyJson
+{
+public:
+    class Value
+    {
+    public:
+        Value();
+
+        bool isValid() const;
+        bool isObject() const;
+        bool isArray() const;
+        bool isString() const;
+
+        // Member of an object, or an invalid value
+        Value operator[](const char *key) const;
+        // Element of an array, or an invalid value
+        Value operator[](int index) const;
+
+        // Iterate an array: first element, then next() until an invalid value
+        Value first() const;
+        Value next() const;
+
+        QString toString() const;
+        double toDouble() const;
+        // Decode the value and everything below it
+        QJsonValue toJsonValue() const;
+
+    private:
+        friend class LazyJson;
+        Value(const LazyJson *json, int token, int begin, int end, int nextToken);
+
+        char firstChar() const;
+
+        const LazyJson *json;
+        int token;      // opening bracket or quote; -1 for numbers, booleans and null
+        int begin;      // byte range of the value
+        int end;
+        int nextToken;  // separator or closing bracket following the value
+    };
+
+    LazyJson(const char *data, int size);
+
+    // Well-formed JSON: brackets balanced, strings terminated, colons and commas
+    // where the grammar puts them, numbers and literals spelled correctly.
+    // Escapes and UTF-8 inside strings are not checked.
+    bool isValid() const;
+    Value root() const;
+
+private:
+    Value valueAfter(int separator) const;
+    char charAt(int token) const;
+    QString decodeString(int begin, int end) const;
+    void scan();
+    bool checkGrammar() const;
+
+    const char *data;
+    int size;
+    bool valid;
+
+    QVector<quint32> positions;  // offsets of the structural characters
+    QVector<quint32> partners;   // for brackets, the token of the matching bracket
+};
+
+#endif // LAZYJSON_H
@@ -0,0 +1,108 @@
+#include "lookuppopup.h"
+#include <QCursor>
+#include <QGuiApplication>
+#include <QJsonArray>
+#include <QScreen>
+#include <QVBoxLayout>
+
+namespace
+{
+    // Sentences mark the looked-up word with <b>; any other markup is shown as text
+    QString sentenceHtml(const QString &text)
+    {
+        QString html = text.toHtmlEscaped();
+        html.replace("&lt;b&gt;", "<b>", Qt::CaseInsensitive);
+        html.replace("&lt;/b&gt;", "</b>", Qt::CaseInsensitive);
+        return html;
+    }
+}
+
+LookupPopup::LookupPopup(QWidget *parent)
+    : QFrame(parent, Qt::ToolTip | Qt::FramelessWindowHint | Qt::WindowStaysOnTopHint)
+    , label(new QLabel(this))
+    , hideTimer(new QTimer(this))
+{
+    setAttribute(Qt::WA_ShowWithoutActivating);
+    setFocusPolicy(Qt::NoFocus);
+    setFrameStyle(QFrame::Box | QFrame::Plain);
+    setStyleSheet("LookupPopup { background-color: #fffff0; border: 1px solid #999; }");
+
+    label->setWordWrap(true);
+    label->setTextFormat(Qt::RichText);
+    label->setStyleSheet("QLabel { font-size: 12px; }");
+    label->setMaximumWidth(360);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(8, 6, 8, 6);
+    layout->addWidget(label);
+
+    hideTimer->setSingleShot(true);
+    hideTimer->setInterval(8000);
+    connect(hideTimer, &QTimer::timeout, this, &QWidget::hide);
+}
+
+void LookupPopup::showEntry(const QString &word, const QJsonObject &wordData, bool found)
+{
+    this->word = word;
+
+    QString html = QString("<b style='color: red; font-size: 14px;'>%1</b>").arg(word.toHtmlEscaped());
+    if (!found) {
+        html += "<br><i>Not found</i>";
+    } else {
+        // The first few meanings and one example are enough at a glance
+        int shown = 0;
+        for (const QJsonValue &value : wordData["translations"].toArray()) {
+            QJsonArray tls = value.toObject()["tls"].toArray();
+            if (tls.isEmpty()) continue;
+            html += QString("<br>%1. %2").arg(++shown).arg(tls[0].toString().toHtmlEscaped());
+            if (shown == 3) break;
+        }
+
+        QJsonArray sentences = wordData["sentences"].toArray();
+        if (!sentences.isEmpty()) {
+            QJsonObject sentence = sentences[0].toObject();
+            html += QString("<br><i style='color: gray;'>%1 - %2</i>").arg(sentenceHtml(sentence["ru"].toString()), sentenceHtml(sentence["tl"].toString()));
+        }
+    }
+    label->setText(html);
+    adjustSize();
+
+    // Below and to the right of the cursor, kept on screen
+    QPoint position = QCursor::pos() + QPoint(16, 16);
+    QScreen *screen = QGuiApplication::screenAt(QCursor::pos());
+    if (!screen) screen = QGuiApplication::primaryScreen();
+    if (screen) {
+        QRect available = screen->availableGeometry();
+        position.setX(qMin(position.x(), available.right() - width()));
+        position.setY(qMin(position.y(), available.bottom() - height()));
+    }
+    move(position);
+
+    show();
+    raise();
+    hideTimer->start();
+}
+
+void LookupPopup::mousePressEvent(QMouseEvent *event)
+{
+    Q_UNUSED(event);
+    hide();
+    emit clicked(word);
+}
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+void LookupPopup::enterEvent(QEnterEvent *event)
+#else
+void LookupPopup::enterEvent(QEvent *event)
+#endif
+{
+    // Stay open while the user is reading it
+    hideTimer->stop();
+    QFrame::enterEvent(event);
+}
+
+void LookupPopup::leaveEvent(QEvent *event)
+{
+    hideTimer->start();
+    QFrame::leaveEvent(event);
+}
@@ -0,0 +1,39 @@
+#ifndef LOOKUPPOPUP_H
+#define LOOKUPPOPUP_H
+
+#include <QFrame>
+#include <QJsonObject>
+#include <QLabel>
+#include <QTimer>
+
+// Small always-on-top window near the mouse cursor showing an entry.
+// It never takes the focus from the application the user is reading in,
+// and hides itself after a few seconds; clicking it opens the word.
+class LookupPopup : public QFrame
+{
+    Q_OBJECT
+
+public:
+    explicit LookupPopup(QWidget *parent = nullptr);
+
+    void showEntry(const QString &word, const QJsonObject &wordData, bool found);
+
+signals:
+    void clicked(const QString &word);
+
+protected:
+    void mousePressEvent(QMouseEvent *event) override;
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    void enterEvent(QEnterEvent *event) override;
+#else
+    void enterEvent(QEvent *event) override;
+#endif
+    void leaveEvent(QEvent *event) override;
+
+private:
+    QLabel *label;
+    QTimer *hideTimer;
+    QString word;
+};
+
+#endif // LOOKUPPOPUP_H
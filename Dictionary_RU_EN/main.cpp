@@ -1,12 +1,151 @@
+#include "cachewarmer.h"
+#include "historyexporter.h"
 #include "mainwindow.h"
+#include "openrussian.h"
+#include "syncbundle.h"
+#include "texttospeech.h"
 #include <QApplication>
+#include <QCommandLineParser>
 #include <QStyleFactory>
 #include <QPalette>
 #include <QFile>
+#include <QScopedPointer>
+#include <QTextStream>
 
 int main(int argc, char *argv[])
 {
-    QApplication app(argc, argv);
+    // --sync and --export exit without opening the window, so they must not
+    // need a display: run them under a QCoreApplication
+    bool headless = false;
+    for (int i = 1; i < argc; ++i) {
+        QByteArray arg(argv[i]);
+        if (arg == "--sync" || arg.startsWith("--sync=") || arg == "--export" || arg.startsWith("--export=")) {
+            headless = true;
+        }
+    }
+    QScopedPointer<QCoreApplication> app(headless ? new QCoreApplication(argc, argv) : new QApplication(argc, argv));
+
+    // Set application properties
+    QCoreApplication::setApplicationName("Ru-En");
+    QCoreApplication::setApplicationVersion("1.0");
+    QCoreApplication::setOrganizationName("YourCompany");
+
+    // Service URLs can be pointed at a local mock server (see tools/loadtest)
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Russian-English dictionary");
+    parser.addHelpOption();
+    QCommandLineOption openRussianUrlOption("openrussian-url", "Base URL of the OpenRussian site.", "url", OpenRussian::baseUrl());
+    QCommandLineOption ttsUrlOption("tts-url", "Base URL of the text-to-speech service.", "url", TextToSpeech::baseUrl());
+    parser.addOption(openRussianUrlOption);
+    parser.addOption(ttsUrlOption);
+
+    // Background cache warming
+    QCommandLineOption warmCacheOption("warm-cache", "Download common words in the background when idle.");
+    QCommandLineOption warmDiskBudgetOption("warm-disk-budget", "Stop warming when the caches use this many MB (0 = unlimited).", "mb", "200");
+    QCommandLineOption warmBandwidthBudgetOption("warm-bandwidth-budget", "Download at most this many MB per session while warming (0 = unlimited).", "mb", "50");
+    QCommandLineOption warmIntervalOption("warm-interval", "Milliseconds between two warming requests.", "ms", "3000");
+    QCommandLineOption warmNoAudioOption("warm-no-audio", "Only warm dictionary entries, not pronunciations.");
+    parser.addOption(warmCacheOption);
+    parser.addOption(warmDiskBudgetOption);
+    parser.addOption(warmBandwidthBudgetOption);
+    parser.addOption(warmIntervalOption);
+    parser.addOption(warmNoAudioOption);
+
+    // Performance statistics dump
+    QCommandLineOption statsFileOption("stats-file", "Periodically write performance statistics to this file (.json or .csv).", "file");
+    QCommandLineOption statsIntervalOption("stats-interval", "Seconds between two statistics dumps.", "seconds", "60");
+    parser.addOption(statsFileOption);
+    parser.addOption(statsIntervalOption);
+
+    // Clipboard lookups
+    QCommandLineOption watchClipboardOption("watch-clipboard", "Look up Russian words copied in other applications and show them in a popup.");
+    parser.addOption(watchClipboardOption);
+
+    // Sync through a shared folder without opening the window
+    QCommandLineOption syncOption("sync", "Exchange history, saved entries and pronunciations with this shared folder and exit.", "folder");
+    parser.addOption(syncOption);
+
+    // History export without opening the window
+    QCommandLineOption exportOption("export", "Export the lookup history to this file (\"-\" for stdout) and exit.", "file");
+    QCommandLineOption exportFormatOption("export-format", "Export format: markdown, jsonl, csv or anki (default: from the file extension).", "format");
+    QCommandLineOption exportSinceOption("export-since", "Only export lookups at or after this date (yyyy-MM-dd).", "date");
+    QCommandLineOption exportUntilOption("export-until", "Only export lookups up to this date (yyyy-MM-dd).", "date");
+    QCommandLineOption exportMatchOption("export-match", "Only export words matching this regular expression.", "regex");
+    parser.addOption(exportOption);
+    parser.addOption(exportFormatOption);
+    parser.addOption(exportSinceOption);
+    parser.addOption(exportUntilOption);
+    parser.addOption(exportMatchOption);
+    parser.process(*app);
+
+    OpenRussian::setBaseUrl(parser.value(openRussianUrlOption));
+    TextToSpeech::setBaseUrl(parser.value(ttsUrlOption));
+
+    if (parser.isSet(syncOption)) {
+        QTextStream err(stderr);
+
+        // Same files MainWindow reads and writes
+        SyncBundle bundle(parser.value(syncOption), "russian_word_history.txt", "word_cache", "word_audio");
+        bool ok = bundle.importBundles();
+        ok = bundle.exportBundle() && ok;
+
+        SyncBundle::Stats stats = bundle.stats();
+        err << "Received " << stats.filesImported << " files and " << stats.historyRecordsAdded << " history records\n";
+        err << "Sent " << stats.chunksWritten << " chunks (" << stats.bytesWritten << " bytes) for "
+            << stats.filesChanged << " of " << stats.filesScanned << " files\n";
+        if (!ok) {
+            err << bundle.errorString() << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    if (parser.isSet(exportOption)) {
+        QTextStream err(stderr);
+        QString outputPath = parser.value(exportOption);
+
+        // Same files MainWindow reads and writes
+        HistoryExporter exporter("russian_word_history.txt", "word_cache");
+        HistoryExporter::Format format = HistoryExporter::formatForFileName(outputPath);
+        if (parser.isSet(exportFormatOption) && !HistoryExporter::formatFromName(parser.value(exportFormatOption), &format)) {
+            err << "Unknown export format: " << parser.value(exportFormatOption) << "\n";
+            return 1;
+        }
+        exporter.setFormat(format);
+
+        // A mistyped filter must not silently export everything
+        if (parser.isSet(exportSinceOption)) {
+            QDate since = QDate::fromString(parser.value(exportSinceOption), Qt::ISODate);
+            if (!since.isValid()) {
+                err << "Invalid --export-since date (expected yyyy-MM-dd): " << parser.value(exportSinceOption) << "\n";
+                return 1;
+            }
+            exporter.setSince(QDateTime(since, QTime(0, 0)));
+        }
+        if (parser.isSet(exportUntilOption)) {
+            QDate until = QDate::fromString(parser.value(exportUntilOption), Qt::ISODate);
+            if (!until.isValid()) {
+                err << "Invalid --export-until date (expected yyyy-MM-dd): " << parser.value(exportUntilOption) << "\n";
+                return 1;
+            }
+            exporter.setUntil(QDateTime(until, QTime(23, 59, 59)));
+        }
+        if (parser.isSet(exportMatchOption)) {
+            QRegularExpression filter(parser.value(exportMatchOption));
+            if (!filter.isValid()) {
+                err << "Invalid --export-match expression: " << filter.errorString() << "\n";
+                return 1;
+            }
+            exporter.setWordFilter(filter);
+        }
+
+        if (!exporter.exportTo(outputPath)) {
+            err << exporter.errorString() << "\n";
+            return 1;
+        }
+        err << "Exported " << exporter.exportedCount() << " entries\n";
+        return 0;
+    }
 
     // Try multiple methods to set icon
     QIcon appIcon;
@@ -31,15 +170,10 @@ int main(int argc, char *argv[])
         }
     }
 
-    app.setWindowIcon(appIcon);
-
-    // Set application properties
-    app.setApplicationName("Ru-En");
-    app.setApplicationVersion("1.0");
-    app.setOrganizationName("YourCompany");
+    QApplication::setWindowIcon(appIcon);
 
     // Set modern Fusion style
-    app.setStyle(QStyleFactory::create("Fusion"));
+    QApplication::setStyle(QStyleFactory::create("Fusion"));
 
     // Optional: Set a dark theme for better appearance
 //    QPalette darkPalette;
@@ -57,12 +191,28 @@ int main(int argc, char *argv[])
 //    darkPalette.setColor(QPalette::Highlight, QColor(42, 130, 218));
 //    darkPalette.setColor(QPalette::HighlightedText, Qt::black);
 
-//    app.setPalette(darkPalette);
-//    app.setStyleSheet("QToolTip { color: #ffffff; background-color: #2a82da; border: 1px solid white; }");
+//    qApp->setPalette(darkPalette);
+//    qApp->setStyleSheet("QToolTip { color: #ffffff; background-color: #2a82da; border: 1px solid white; }");
 
     // Create and show main window
     MainWindow window;
+
+    CacheWarmer *warmer = window.warmer();
+    warmer->setDiskBudget(qint64(parser.value(warmDiskBudgetOption).toDouble() * 1024 * 1024));
+    warmer->setBandwidthBudget(qint64(parser.value(warmBandwidthBudgetOption).toDouble() * 1024 * 1024));
+    warmer->setRequestInterval(parser.value(warmIntervalOption).toInt());
+    warmer->setWarmAudio(!parser.isSet(warmNoAudioOption));
+    if (parser.isSet(warmCacheOption)) {
+        window.setWarmCache(true);
+    }
+    if (parser.isSet(watchClipboardOption)) {
+        window.setClipboardWatch(true);
+    }
+    if (parser.isSet(statsFileOption)) {
+        window.setStatsFile(parser.value(statsFileOption), parser.value(statsIntervalOption).toInt());
+    }
+
     window.show();
 
-    return app.exec();
+    return app->exec();
 }
@@ -1,4 +1,18 @@
 #include "mainwindow.h"
+#include "cachewarmer.h"
+#include "clipboardlookup.h"
+#include "concordance.h"
+#include "dictionarybackend.h"
+#include "entrycache.h"
+#include "historyexporter.h"
+#include "lookuppopup.h"
+#include "openrussian.h"
+#include "openrussianbackend.h"
+#include "perfstats.h"
+#include "phraselookup.h"
+#include "reverseindex.h"
+#include "syncbundle.h"
+#include "texttospeech.h"
 #include <QShowEvent>
 #include <QRegularExpression>
 #include <QEvent>
@@ -8,10 +22,18 @@
 #include <QMediaPlayer>
 #include <QAudioOutput>
 #include <QDir>
+#include <QFileDialog>
 #include <QProgressBar>
+#include <QProgressDialog>
+#include <QPointer>
+#include <QDateEdit>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QFormLayout>
 #include <QApplication>
 #include <QClipboard>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -22,19 +44,90 @@
 #include <QHBoxLayout>
 #include <QPushButton>
 #include <QMediaPlayer>
+#include <QThreadPool>
+#include <QtConcurrent>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
+    , ttsNetworkManager(new QNetworkAccessManager())
+    , playbackRequestedAt(0)
     , historyFile("russian_word_history.txt")
     , isConverting(false)
-    , networkManager(new QNetworkAccessManager())
-    , ttsNetworkManager(new QNetworkAccessManager())
+    , audioPlaybackEnabled(true)
+    , syncInProgress(false)
 {
     setupUI();
 
-    connect(networkManager, &QNetworkAccessManager::finished, this, &MainWindow::onNetworkReply);
     connect(ttsNetworkManager, &QNetworkAccessManager::finished, this, &MainWindow::onTtsReply);
 
+    // Parsed entries are cached in word_cache so repeated lookups skip the network
+    entryCache = new EntryCache("word_cache", this);
+
+    // Offline StarDict/DSL dictionaries are answered first, OpenRussian.org is merged in.
+    // They are opened in the background and attached once ready.
+    dictionaryLoader = new QFutureWatcher<QList<LocalDictionaryBackend *>>(this);
+    connect(dictionaryLoader, &QFutureWatcher<QList<LocalDictionaryBackend *>>::finished, this, &MainWindow::onDictionariesLoaded);
+    QThread *guiThread = thread();
+    dictionaryLoader->setFuture(QtConcurrent::run([guiThread]() {
+        return LocalDictionaryBackend::loadDirectory("dictionaries", guiThread);
+    }));
+    openRussianBackend = new OpenRussianBackend(entryCache, this);
+    connect(openRussianBackend, &DictionaryBackend::lookupFinished, this, &MainWindow::onBackendLookupFinished);
+
+    phraseLookup = new PhraseLookup(entryCache, this);
+
+    // Words copied in other applications are looked up and shown in a popup
+    clipboardLookup = new ClipboardLookup(entryCache, this);
+    lookupPopup = new LookupPopup();
+    connect(clipboardLookup, &ClipboardLookup::wordResolved, this, &MainWindow::onClipboardWordResolved);
+    connect(lookupPopup, &LookupPopup::clicked, this, &MainWindow::onPopupClicked);
+    connect(clipboardWatchCheckbox, &QCheckBox::toggled, clipboardLookup, &ClipboardLookup::setEnabled);
+
+    // English -> Russian index over the cached entries, kept up to date as entries are parsed
+    reverseIndex = new ReverseIndex(this);
+    connect(entryCache, &EntryCache::entryStored, reverseIndex, &ReverseIndex::addEntry);
+    reverseIndex->buildFromDirectory(entryCache->directory());
+
+    // Every example sentence seen so far, searchable by any substring
+    concordance = new Concordance("sentence_corpus", this);
+    connect(entryCache, &EntryCache::entryStored, concordance, &Concordance::addEntry);
+    concordance->open(entryCache->directory());
+
+    // Warm the cache while the window is deactivated or has been idle for a minute
+    cacheWarmer = new CacheWarmer(entryCache, this);
+    connect(cacheWarmer, &CacheWarmer::progressChanged, this, &MainWindow::onWarmerProgress);
+    connect(warmCacheCheckbox, &QCheckBox::toggled, this, &MainWindow::onWarmCacheToggled);
+
+    idleTimer = new QTimer(this);
+    idleTimer->setSingleShot(true);
+    idleTimer->setInterval(60 * 1000);
+    connect(idleTimer, &QTimer::timeout, cacheWarmer, &CacheWarmer::resume);
+
+    // Statistics dock refreshes once a second while visible
+    statsRefreshTimer = new QTimer(this);
+    statsRefreshTimer->setInterval(1000);
+    connect(statsRefreshTimer, &QTimer::timeout, this, &MainWindow::refreshStatsDock);
+    connect(statsDock, &QDockWidget::visibilityChanged, this, [this](bool visible) {
+        statsButton->setChecked(visible);
+        if (visible) {
+            refreshStatsDock();
+            statsRefreshTimer->start();
+        } else {
+            statsRefreshTimer->stop();
+        }
+    });
+
+    statsFileTimer = new QTimer(this);
+    connect(statsFileTimer, &QTimer::timeout, this, &MainWindow::writeStatsFile);
+    connect(phraseLookup, &PhraseLookup::wordResolved, this, &MainWindow::onPhraseWordResolved);
+
+    // Words resolved in a burst (e.g. all cached) are rendered once
+    phraseRenderTimer = new QTimer(this);
+    phraseRenderTimer->setSingleShot(true);
+    phraseRenderTimer->setInterval(0);
+    connect(phraseRenderTimer, &QTimer::timeout, this, &MainWindow::renderPhraseGloss);
+    connect(phraseLookup, &PhraseLookup::finished, this, &MainWindow::onPhraseLookupFinished);
+
     // Setup media player for audio playback
     mediaPlayer = new QMediaPlayer();
 
@@ -64,11 +157,27 @@ MainWindow::MainWindow(QWidget *parent)
     }
 
     loadHistory();
+
+    // Words around the most recent lookups are warmed first, newest first
+    for (int i = qMin(historyList->count(), 20) - 1; i >= 0; --i) {
+        cacheWarmer->addRecentWord(historyList->item(i)->data(Qt::UserRole).toString());
+    }
 }
 
 MainWindow::~MainWindow()
 {
+    // A history export or sync still running on the thread pool uses this window's objects
+    QThreadPool::globalInstance()->waitForDone();
+    // Entries stored while a sync was running still have to reach the disk
+    entryCache->setWritesHeld(false);
+
+    // The periodic writes miss whatever happened since the last interval
+    if (!statsFile.isEmpty()) {
+        PerfStats::instance().writeToFile(statsFile);
+    }
+
     // Clean up
+    delete lookupPopup;
     #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
     delete audioOutput;
     #endif
@@ -92,9 +201,18 @@ void MainWindow::setupUI()
     wordInput->setPlaceholderText("Type using English keyboard - characters will convert to Russian automatically...");
     wordInput->setStyleSheet("QLineEdit { padding: 8px; font-size: 14px; }");
 
+    // Lookup direction checkbox
+    reverseModeCheckbox = new QCheckBox("English to Russian (search the translations of saved words)", leftPanel);
+
     // Audio playback checkbox
     autoPlayCheckbox = new QCheckBox("Auto-play pronunciation after lookup", leftPanel);
 
+    // Clipboard watch checkbox
+    clipboardWatchCheckbox = new QCheckBox("Look up Russian words copied in other applications", leftPanel);
+
+    // Background cache warming checkbox
+    warmCacheCheckbox = new QCheckBox("Download common words in the background when idle", leftPanel);
+
     // Progress bars
     lookupProgressBar = new QProgressBar(leftPanel);
     lookupProgressBar->setVisible(false);
@@ -113,14 +231,20 @@ void MainWindow::setupUI()
 
     QHBoxLayout *buttonLayout = new QHBoxLayout();
     lookupButton = new QPushButton("Lookup", leftPanel);
+    examplesButton = new QPushButton("Search Examples", leftPanel);
+    examplesButton->setToolTip("Find the typed text in all saved example sentences");
     copyButton = new QPushButton("Copy as Markdown", leftPanel);
 
     buttonLayout->addWidget(lookupButton);
+    buttonLayout->addWidget(examplesButton);
     buttonLayout->addWidget(copyButton);
     buttonLayout->addStretch();
 
     leftLayout->addWidget(wordInput);
+    leftLayout->addWidget(reverseModeCheckbox);
     leftLayout->addWidget(autoPlayCheckbox);
+    leftLayout->addWidget(clipboardWatchCheckbox);
+    leftLayout->addWidget(warmCacheCheckbox);
     leftLayout->addWidget(lookupProgressBar);
     leftLayout->addWidget(audioProgressBar);
     leftLayout->addWidget(lookupLabel);
@@ -145,12 +269,24 @@ void MainWindow::setupUI()
     historyDetailDisplay->setStyleSheet("QTextEdit { background-color: #f8f8f8; padding: 10px; font-size: 11px; border: 1px solid #ccc; }");
 
     copyHistoryButton = new QPushButton("Copy as Markdown", rightPanel);
+    exportHistoryButton = new QPushButton("Export...", rightPanel);
+    exportHistoryButton->setToolTip("Export the whole history to Markdown, JSON Lines, CSV or Anki");
+    syncButton = new QPushButton("Sync...", rightPanel);
+    syncButton->setToolTip("Exchange history, saved entries and pronunciations with other machines through a shared folder");
+    statsButton = new QPushButton("Statistics", rightPanel);
+    statsButton->setCheckable(true);
+
+    QHBoxLayout *historyButtonLayout = new QHBoxLayout();
+    historyButtonLayout->addWidget(copyHistoryButton);
+    historyButtonLayout->addWidget(exportHistoryButton);
+    historyButtonLayout->addWidget(syncButton);
+    historyButtonLayout->addWidget(statsButton);
 
     rightLayout->addWidget(historyLabel);
     rightLayout->addWidget(historyList);
     rightLayout->addWidget(historyDetailLabel);
     rightLayout->addWidget(historyDetailDisplay);
-    rightLayout->addWidget(copyHistoryButton);
+    rightLayout->addLayout(historyButtonLayout);
 
     mainSplitter->addWidget(leftPanel);
     mainSplitter->addWidget(rightPanel);
@@ -163,54 +299,402 @@ void MainWindow::setupUI()
     statusLabel->setStyleSheet("QLabel { color: #666; font-size: 10px; padding: 5px; background-color: #f0f0f0; }");
     mainLayout->addWidget(statusLabel);
 
+    // Statistics dock, next to the history pane
+    statsDock = new QDockWidget("Performance Statistics", this);
+    statsDisplay = new QPlainTextEdit(statsDock);
+    statsDisplay->setReadOnly(true);
+    statsDisplay->setStyleSheet("QPlainTextEdit { font-family: monospace; font-size: 10px; }");
+    statsDock->setWidget(statsDisplay);
+    addDockWidget(Qt::RightDockWidgetArea, statsDock);
+    statsDock->hide();
+
     // Connect signals and slots
     connect(wordInput, &QLineEdit::returnPressed, this, &MainWindow::onLookupWord);
     connect(wordInput, &QLineEdit::textChanged, this, &MainWindow::onTextChanged);
     connect(lookupButton, &QPushButton::clicked, this, &MainWindow::onLookupWord);
+    connect(examplesButton, &QPushButton::clicked, this, &MainWindow::searchExamples);
     connect(copyButton, &QPushButton::clicked, this, &MainWindow::copyToClipboard);
     connect(copyHistoryButton, &QPushButton::clicked, this, &MainWindow::copyHistoryToClipboard);
+    connect(exportHistoryButton, &QPushButton::clicked, this, &MainWindow::exportHistory);
+    connect(syncButton, &QPushButton::clicked, this, &MainWindow::syncWithDirectory);
     connect(historyList, &QListWidget::itemClicked, this, &MainWindow::onHistoryItemClicked);
+    connect(statsButton, &QPushButton::toggled, statsDock, &QDockWidget::setVisible);
+    connect(reverseModeCheckbox, &QCheckBox::toggled, this, &MainWindow::onReverseModeToggled);
 
     wordInput->setFocus();
 }
+void MainWindow::lookupWord(const QString &word)
+{
+    wordInput->setText(word);
+    onLookupWord();
+}
+
+void MainWindow::setAutoPlay(bool enabled)
+{
+    autoPlayCheckbox->setChecked(enabled);
+}
+
+void MainWindow::setAudioPlaybackEnabled(bool enabled)
+{
+    audioPlaybackEnabled = enabled;
+}
+
+CacheWarmer *MainWindow::warmer() const
+{
+    return cacheWarmer;
+}
+
+void MainWindow::setWarmCache(bool enabled)
+{
+    warmCacheCheckbox->setChecked(enabled);
+}
+
+void MainWindow::onWarmCacheToggled(bool checked)
+{
+    cacheWarmer->setEnabled(checked);
+    if (checked && !isActiveWindow()) {
+        cacheWarmer->resume();
+    } else if (checked) {
+        idleTimer->start();
+    }
+    onWarmerProgress();
+}
+
+void MainWindow::onWarmerProgress()
+{
+    CacheWarmer::Stats stats = cacheWarmer->stats();
+
+    QString state = stats.budgetExhausted ? "budget used up" : (stats.running ? "running" : "paused");
+    warmCacheCheckbox->setText(QString("Download common words in the background when idle (%1: %2 words, %3 clips, %4 MB)")
+                               .arg(state).arg(stats.entriesWarmed).arg(stats.audioWarmed)
+                               .arg(stats.bytesDownloaded / 1048576.0, 0, 'f', 1));
+    warmCacheCheckbox->setToolTip(QString("%1 words queued, %2 failures, %3 MB of cache on disk")
+                                  .arg(stats.queued).arg(stats.failures)
+                                  .arg(stats.diskUsed / 1048576.0, 0, 'f', 1));
+}
+
+void MainWindow::setStatsFile(const QString &filePath, int intervalSeconds)
+{
+    statsFile = filePath;
+    if (statsFile.isEmpty()) {
+        statsFileTimer->stop();
+    } else {
+        statsFileTimer->start(qMax(1, intervalSeconds) * 1000);
+    }
+}
+
+void MainWindow::writeStatsFile()
+{
+    if (!PerfStats::instance().writeToFile(statsFile)) {
+        statusLabel->setText("Could not write statistics to " + statsFile);
+    }
+}
+
+void MainWindow::refreshStatsDock()
+{
+    statsDisplay->setPlainText(PerfStats::instance().toText());
+}
+
+void MainWindow::noteUserActivity()
+{
+    // Warming yields to the user and restarts after a quiet minute
+    cacheWarmer->pause();
+    if (cacheWarmer->isEnabled() && isActiveWindow()) {
+        idleTimer->start();
+    }
+}
+
 void MainWindow::onLookupWord()
 {
+    noteUserActivity();
+
     QString russianWord = wordInput->text().trimmed();
     if (russianWord.isEmpty()) {
         resultDisplay->setText("Please enter a Russian word to lookup.");
         return;
     }
 
+    if (reverseModeCheckbox->isChecked()) {
+        lookupEnglish(russianWord);
+        return;
+    }
+
+    // More than one word: look them all up and show an interlinear gloss
+    QStringList tokens = PhraseLookup::tokenize(russianWord);
+    if (tokens.size() > 1) {
+        lookupPhrase(tokens);
+        return;
+    }
+    phraseLookup->abort();
+
     currentWord = russianWord;
 
+    // Local dictionaries answer instantly
+    localEntry = QJsonObject();
+    bool foundLocally = LocalDictionaryBackend::findInAll(localBackends, russianWord, &localEntry);
+
+    // Serve previously fetched entries straight from the cache
+    QJsonObject wordData;
+    bool cached = entryCache->lookup(russianWord, &wordData);
+    PerfStats::instance().add(cached ? PerfStats::CacheHits : PerfStats::CacheMisses);
+    if (cached) {
+        showWordEntry(russianWord, foundLocally ? DictionaryBackend::mergeEntries(wordData, localEntry) : wordData);
+        emit lookupFinished(russianWord, true);
+
+        if (autoPlayCheckbox->isChecked()) {
+            downloadAndPlayAudio(currentWord, "ru");
+        }
+        return;
+    }
+
     // Show lookup progress
     lookupProgressBar->setVisible(true);
-    statusLabel->setText("Looking up Russian word: " + russianWord);
-    resultDisplay->setText("Searching OpenRussian.org...");
-
-    // Use en.openrussian.org - the correct English interface
-    QString url = QString("https://en.openrussian.org/ru/%1").arg(russianWord);
+    if (foundLocally) {
+        // Show the offline result while OpenRussian.org is queried
+        displayWordEntry(russianWord, localEntry);
+        statusLabel->setText("Found in local dictionaries, querying OpenRussian.org: " + russianWord);
+    } else {
+        statusLabel->setText("Looking up Russian word: " + russianWord);
+        resultDisplay->setText("Searching OpenRussian.org...");
+    }
 
-    networkManager->get(QNetworkRequest(QUrl(url)));
+    openRussianBackend->lookup(russianWord);
 }
 
-void MainWindow::onNetworkReply(QNetworkReply *reply)
+void MainWindow::onBackendLookupFinished(const QString &word, bool found, const QJsonObject &wordData, const QString &errorString)
 {
+    // A newer lookup has started in the meantime
+    if (word != currentWord) return;
+
     lookupProgressBar->setVisible(false);
 
-    if (reply->error() == QNetworkReply::NoError) {
-        QByteArray data = reply->readAll();
-        parseOpenRussianResponse(data, currentWord);
+    if (found) {
+        showWordEntry(word, localEntry.isEmpty() ? wordData : DictionaryBackend::mergeEntries(wordData, localEntry));
+    } else if (!localEntry.isEmpty()) {
+        // Fall back to the local dictionaries alone
+        showWordEntry(word, localEntry);
+    } else {
+        resultDisplay->setText(errorString);
+        statusLabel->setText("Error");
+        emit lookupFinished(word, false);
+        return;
+    }
+    emit lookupFinished(word, true);
 
-        // Auto-play audio if checkbox is checked
-        if (autoPlayCheckbox->isChecked() && !currentWord.isEmpty()) {
-            downloadAndPlayAudio(currentWord, "ru");
+    // Auto-play audio if checkbox is checked
+    if (autoPlayCheckbox->isChecked() && !currentWord.isEmpty()) {
+        downloadAndPlayAudio(currentWord, "ru");
+    }
+}
+
+void MainWindow::setClipboardWatch(bool enabled)
+{
+    clipboardWatchCheckbox->setChecked(enabled);
+}
+
+void MainWindow::onClipboardWordResolved(const QString &word, const QJsonObject &wordData, bool found)
+{
+    lookupPopup->showEntry(word, wordData, found);
+    if (found) {
+        cacheWarmer->addRecentWord(word);
+    }
+}
+
+void MainWindow::onPopupClicked(const QString &word)
+{
+    // Open the full entry; showWordEntry's clipboard copy is ignored by the watcher
+    showNormal();
+    raise();
+    activateWindow();
+    wordInput->setText(word);
+    lookupWord(word);
+}
+
+void MainWindow::onDictionariesLoaded()
+{
+    localBackends = dictionaryLoader->result();
+    for (LocalDictionaryBackend *backend : localBackends) {
+        backend->setParent(this);
+    }
+    phraseLookup->setLocalBackends(localBackends);
+    clipboardLookup->setLocalBackends(localBackends);
+
+    if (!localBackends.isEmpty()) {
+        statusLabel->setText(QString("%1 local dictionaries loaded").arg(localBackends.size()));
+    }
+}
+
+void MainWindow::onReverseModeToggled(bool checked)
+{
+    if (checked) {
+        wordInput->setPlaceholderText("Type an English word or phrase to find its Russian translations...");
+        statusLabel->setText(QString("English to Russian - %1 saved words indexed").arg(reverseIndex->size()));
+    } else {
+        wordInput->setPlaceholderText("Type using English keyboard - characters will convert to Russian automatically...");
+        statusLabel->setText("Ready - Type using English keyboard, characters convert to Russian automatically");
+    }
+    wordInput->clear();
+    wordInput->setFocus();
+}
+
+void MainWindow::lookupEnglish(const QString &query)
+{
+    phraseLookup->abort();
+    currentWord.clear();
+
+    QElapsedTimer timer;
+    timer.start();
+    QVector<ReverseIndex::Match> matches = reverseIndex->search(query);
+    double elapsedMs = timer.nsecsElapsed() / 1e6;
+
+    QString result = QString("<h2 style='color: red;'>%1</h2>").arg(query.toHtmlEscaped());
+    QString markdown = QString("# %1\n\n").arg(query);
+
+    if (matches.isEmpty()) {
+        result += "<p>No saved word has this translation. Words are indexed once they have been looked up.</p>";
+    } else {
+        result += "<h3 style='color: #2E86AB; background-color: #f0f0f0; padding: 5px;'>Russian</h3>";
+        result += "<ul>";
+        for (const ReverseIndex::Match &match : matches) {
+            result += QString("<li><b style='color: red;'>%1</b> - %2</li>").arg(match.word.toHtmlEscaped(), match.translation.toHtmlEscaped());
+            markdown += QString("* **%1** - %2\n").arg(match.word, match.translation);
         }
+        result += "</ul>";
+    }
+
+    currentMarkdown = markdown;
+    resultDisplay->setHtml(result);
+
+    QString indexState = reverseIndex->isReady() ? QString() : " (index still loading)";
+    statusLabel->setText(QString("%1 matches in %2 ms%3").arg(matches.size()).arg(elapsedMs, 0, 'f', 2).arg(indexState));
+}
+
+void MainWindow::searchExamples()
+{
+    QString query = wordInput->text().trimmed();
+    if (query.isEmpty()) {
+        statusLabel->setText("Please enter text to search the example sentences");
+        return;
+    }
+    noteUserActivity();
+
+    QElapsedTimer timer;
+    timer.start();
+    QVector<Concordance::Hit> hits = concordance->search(query);
+    double elapsedMs = timer.nsecsElapsed() / 1e6;
+
+    QString result = QString("<h2 style='color: red;'>%1</h2>").arg(query.toHtmlEscaped());
+    QString markdown = QString("# %1\n\n").arg(query);
+
+    if (hits.isEmpty()) {
+        result += "<p>No saved example sentence contains this text.</p>";
     } else {
-        resultDisplay->setText("Word not found or network error: " + reply->errorString());
-        statusLabel->setText("Error");
+        // Keyword in context: the match lines up in the middle column
+        result += "<table cellspacing='0' cellpadding='2'>";
+        for (const Concordance::Hit &hit : hits) {
+            result += QString("<tr><td align='right'>%1</td><td><b style='color: red;'>%2</b>%3</td></tr>")
+                          .arg(hit.left.toHtmlEscaped(), hit.match.toHtmlEscaped(), hit.right.toHtmlEscaped());
+            result += QString("<tr><td></td><td style='color: gray;'>%1 <i>(%2)</i></td></tr>")
+                          .arg(hit.translation.toHtmlEscaped(), hit.headword.toHtmlEscaped());
+            markdown += QString("* %1**%2**%3 - %4\n").arg(hit.left, hit.match, hit.right, hit.translation);
+        }
+        result += "</table>";
     }
-    reply->deleteLater();
+
+    currentWord.clear();
+    currentMarkdown = markdown;
+    resultDisplay->setHtml(result);
+
+    QString indexState = concordance->isIndexing() ? " (index updating)" : QString();
+    statusLabel->setText(QString("%1 examples found in %2 sentences, %3 ms%4")
+                             .arg(hits.size()).arg(concordance->sentenceCount()).arg(elapsedMs, 0, 'f', 2).arg(indexState));
+}
+
+void MainWindow::lookupPhrase(const QStringList &tokens)
+{
+    phraseTokens = tokens;
+    phraseGlosses.clear();
+    phraseMissing.clear();
+
+    QStringList words;
+    for (const QString &token : tokens) {
+        QString word = PhraseLookup::normalizeToken(token);
+        if (!phraseGlosses.contains(word)) {
+            phraseGlosses.insert(word, QString());
+            words << word;
+        }
+    }
+
+    currentWord.clear();
+    currentMarkdown.clear();
+    lookupProgressBar->setVisible(true);
+    statusLabel->setText(QString("Looking up %1 distinct words...").arg(words.size()));
+    renderPhraseGloss();
+
+    phraseLookup->start(words);
+}
+
+void MainWindow::onPhraseWordResolved(const QString &word, const QJsonObject &wordData, bool found)
+{
+    if (!phraseGlosses.contains(word)) return;
+
+    QString gloss = found ? OpenRussian::firstTranslation(wordData) : QString();
+    // An empty (non-null) string marks a word that has been resolved without a translation
+    phraseGlosses[word] = gloss.isNull() ? QString("") : gloss;
+    if (!found) {
+        phraseMissing.insert(word);
+    }
+    phraseRenderTimer->start();
+}
+
+void MainWindow::onPhraseLookupFinished()
+{
+    lookupProgressBar->setVisible(false);
+    phraseRenderTimer->stop();
+    renderPhraseGloss();
+
+    int found = phraseGlosses.size() - phraseMissing.size();
+    statusLabel->setText(QString("Phrase - %1 of %2 words found - %3")
+                         .arg(found).arg(phraseGlosses.size())
+                         .arg(QDateTime::currentDateTime().toString("hh:mm:ss")));
+}
+
+void MainWindow::renderPhraseGloss()
+{
+    // Word-by-word interlinear gloss: Russian on top, first translation below
+    const int tokensPerRow = 6;
+    qint64 renderStarted = PerfStats::now();
+
+    QString result;
+    result += "<h3 style='color: #2E86AB; background-color: #f0f0f0; padding: 5px;'>Phrase</h3>";
+    result += "<table cellspacing='0' cellpadding='6'>";
+
+    for (int row = 0; row < phraseTokens.size(); row += tokensPerRow) {
+        QString ruRow = "<tr>";
+        QString enRow = "<tr>";
+        for (int i = row; i < phraseTokens.size() && i < row + tokensPerRow; ++i) {
+            QString word = PhraseLookup::normalizeToken(phraseTokens[i]);
+            QString gloss = phraseGlosses.value(word);
+            if (gloss.isNull()) {
+                gloss = "<span style='color: #aaa;'>...</span>";
+            } else if (phraseMissing.contains(word)) {
+                gloss = "<span style='color: #aaa;'>?</span>";
+            } else if (gloss.isEmpty()) {
+                // Known word whose entry has no translation
+                gloss = "<span style='color: #aaa;'>-</span>";
+            } else {
+                gloss = gloss.toHtmlEscaped();
+            }
+
+            ruRow += QString("<td><b style='color: red;'>%1</b></td>").arg(phraseTokens[i].toHtmlEscaped());
+            enRow += QString("<td style='color: #555;'><i>%1</i></td>").arg(gloss);
+        }
+        result += ruRow + "</tr>" + enRow + "</tr>";
+    }
+    result += "</table>";
+
+    resultDisplay->setHtml(result);
+    PerfStats::instance().recordSince(PerfStats::LookupRender, renderStarted);
 }
 
 void MainWindow::downloadAndPlayAudio(const QString &text, const QString &language)
@@ -218,50 +702,48 @@ void MainWindow::downloadAndPlayAudio(const QString &text, const QString &langua
     if (text.isEmpty()) return;
 
     // Check if audio file already exists locally
-    QString safeWord = text;
-    safeWord.replace(QRegularExpression("[^a-zA-Z0-9а-яА-ЯёЁ]"), "_");
-    QString localAudioFile = QString("word_audio/%1_%2.mp3").arg(safeWord).arg(language);
+    QString localAudioFile = TextToSpeech::localFilePath(text, language);
     QFile file(localAudioFile);
     if (file.exists()) {
         // Play local audio file using Qt Multimedia
         playAudioFile(localAudioFile);
+        emit audioFinished(text, true);
         return;
     }
 
     statusLabel->setText("Downloading audio pronunciation...");
     audioProgressBar->setVisible(true);
 
-    // Encode text for URL
-    QString encodedText = QUrl::toPercentEncoding(text);
-
-    // Construct Google TTS URL
-    QString url;
-    if (language == "ru") {
-        url = QString("https://translate.google.com/translate_tts?ie=UTF-8&tl=ru&client=tw-ob&q=%1").arg(encodedText);
-    } else {
-        url = QString("https://translate.google.com/translate_tts?ie=UTF-8&tl=en&client=tw-ob&q=%1").arg(encodedText);
-    }
-
     // Set headers to mimic a real browser
-    QNetworkRequest request(url);
+    QNetworkRequest request(TextToSpeech::speechUrl(text, language));
     request.setRawHeader("User-Agent", "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/91.0.4472.124 Safari/537.36");
     request.setRawHeader("Referer", "https://translate.google.com/");
 
-    // Download the audio
-    ttsNetworkManager->get(request);
+    // Download the audio, remembering what it is for: currentWord may change before it arrives
+    QNetworkReply *reply = ttsNetworkManager->get(request);
+    reply->setProperty("word", text);
+    reply->setProperty("language", language);
+    reply->setProperty("started", PerfStats::now());
+    PerfStats::instance().add(PerfStats::InFlightRequests);
 }
 
 void MainWindow::onTtsReply(QNetworkReply *reply)
 {
     audioProgressBar->setVisible(false);
 
+    PerfStats &stats = PerfStats::instance();
+    stats.add(PerfStats::InFlightRequests, -1);
+
+    QString word = reply->property("word").toString();
+    QString language = reply->property("language").toString();
+
     if (reply->error() == QNetworkReply::NoError) {
         QByteArray audioData = reply->readAll();
+        stats.recordSince(PerfStats::TtsDownload, reply->property("started").toLongLong());
+        stats.add(PerfStats::BytesDownloaded, audioData.size());
 
         // Save to word_audio folder with filename based on the word
-        QString safeWord = currentWord;
-        safeWord.replace(QRegularExpression("[^a-zA-Z0-9а-яА-ЯёЁ]"), "_");
-        QString localAudioFile = QString("word_audio/%1_ru.mp3").arg(safeWord);
+        QString localAudioFile = TextToSpeech::localFilePath(word, language);
 
         QFile file(localAudioFile);
         if (file.open(QIODevice::WriteOnly)) {
@@ -270,17 +752,22 @@ void MainWindow::onTtsReply(QNetworkReply *reply)
 
             // Play the audio using Qt Multimedia
             playAudioFile(localAudioFile);
+            emit audioFinished(word, true);
         } else {
             statusLabel->setText("Error saving audio file");
+            emit audioFinished(word, false);
         }
     } else {
         statusLabel->setText("Audio download failed: " + reply->errorString());
+        emit audioFinished(word, false);
     }
     reply->deleteLater();
 }
 
 void MainWindow::playAudioFile(const QString &filePath)
 {
+    if (!audioPlaybackEnabled) return;
+
     statusLabel->setText("Playing pronunciation...");
 
     #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
@@ -291,6 +778,7 @@ void MainWindow::playAudioFile(const QString &filePath)
     mediaPlayer->setMedia(QUrl::fromLocalFile(filePath));
     #endif
 
+    playbackRequestedAt = PerfStats::now();
     mediaPlayer->play();
 }
 
@@ -300,6 +788,10 @@ void MainWindow::onMediaStateChanged(QMediaPlayer::State state)
 {
     switch (state) {
     case QMediaPlayer::PlayingState:
+        if (playbackRequestedAt) {
+            PerfStats::instance().recordSince(PerfStats::PlaybackStart, playbackRequestedAt);
+            playbackRequestedAt = 0;
+        }
         statusLabel->setText("Playing pronunciation...");
         break;
     case QMediaPlayer::StoppedState:
@@ -336,6 +828,12 @@ void MainWindow::onMediaStatusChanged(QMediaPlayer::MediaStatus status)
     case QMediaPlayer::LoadedMedia:
         statusLabel->setText("Audio loaded, playing...");
         break;
+    case QMediaPlayer::BufferedMedia:
+        if (playbackRequestedAt) {
+            PerfStats::instance().recordSince(PerfStats::PlaybackStart, playbackRequestedAt);
+            playbackRequestedAt = 0;
+        }
+        break;
     case QMediaPlayer::EndOfMedia:
         statusLabel->setText("Audio finished playing");
         break;
@@ -367,12 +865,16 @@ void MainWindow::onPlayerError(QMediaPlayer::Error error, const QString &errorSt
 bool MainWindow::event(QEvent *event)
 {
     if (event->type() == QEvent::WindowActivate) {
+        noteUserActivity();
         wordInput->setFocus();
         wordInput->selectAll();
         return true;
     }
     else if (event->type() == QEvent::WindowDeactivate) {
         wordInput->clear();
+        idleTimer->stop();
+        // The sync dialog deactivates the window too; warming waits for the sync
+        if (!syncInProgress) cacheWarmer->resume();
         return true;
     }
 
@@ -443,6 +945,11 @@ void MainWindow::onTextChanged(const QString &text)
 {
     if (isConverting) return;
 
+    noteUserActivity();
+
+    // English input is left as typed; it is searched on Enter or the Lookup button
+    if (reverseModeCheckbox->isChecked()) return;
+
     isConverting = true;
 
     // Get current cursor position
@@ -467,107 +974,17 @@ void MainWindow::onTextChanged(const QString &text)
     isConverting = false;
 }
 
-void MainWindow::parseOpenRussianResponse(const QByteArray &data, const QString &word)
-{
-    QString html = QString::fromUtf8(data);
-
-    // Extract JSON data from the script tag
-    QString jsonData;
-    QRegularExpression jsonRegex("<script id=\"__NEXT_DATA__\" type=\"application/json\">(.*?)</script>");
-    QRegularExpressionMatch jsonMatch = jsonRegex.match(html);
-
-    if (jsonMatch.hasMatch()) {
-        jsonData = jsonMatch.captured(1);
-
-        QJsonDocument doc = QJsonDocument::fromJson(jsonData.toUtf8());
-        if (!doc.isNull()) {
-            QJsonObject root = doc.object();
-            QJsonObject props = root["props"].toObject();
-            QJsonObject pageProps = props["pageProps"].toObject();
-            QJsonObject info = pageProps["info"].toObject();
-
-            // Extract translations from JSON
-            QJsonArray words = info["words"].toArray();
-            if (!words.isEmpty()) {
-                QJsonObject wordData = words[0].toObject();
-                QJsonArray translations = wordData["translations"].toArray();
-
-                // Format for display
-                QString result;
-                result += QString("<h2 style='color: red;'>%1</h2>").arg(word);
-                result += "<h3 style='color: #2E86AB; background-color: #f0f0f0; padding: 5px;'>Translations</h3>";
-                result += "<ul>";
-
-                // Use a counter instead of indexOf
-                int translationIndex = 1;
-                for (const QJsonValue &transValue : translations) {
-                    QJsonObject translation = transValue.toObject();
-                    QJsonArray tls = translation["tls"].toArray();
-
-                    if (!tls.isEmpty()) {
-                        QString translationText = tls[0].toString();
-                        result += QString("<li><b>%1</b> - %2").arg(translationIndex).arg(translationText);
-
-                        // Add example if available
-                        QString exampleRu = translation["exampleRu"].toString();
-                        QString exampleTl = translation["exampleTl"].toString();
-                        if (!exampleRu.isEmpty() && !exampleTl.isEmpty()) {
-                            result += QString("<br><i>Example: %1 - %2</i>").arg(exampleRu, exampleTl);
-                        }
-
-                        result += "</li>";
-                        translationIndex++;
-                    }
-                }
-                result += "</ul>";
-
-                // Extract examples
-                QJsonArray sentences = wordData["sentences"].toArray();
-                if (!sentences.isEmpty()) {
-                    result += "<h3 style='color: #2E86AB; background-color: #f0f0f0; padding: 5px;'>Examples</h3>";
-                    result += "<ul>";
-
-                    for (int i = 0; i < sentences.size() && i < 10; ++i) {
-                        QJsonObject sentence = sentences[i].toObject();
-                        QString ru = sentence["ru"].toString();
-                        QString tl = sentence["tl"].toString();
-
-                        result += QString("<li><b>Russian:</b> %1<br><b>English:</b> %2</li>").arg(ru, tl);
-                    }
-                    result += "</ul>";
-                }
-
-                currentDefinition = result;
-
-                // Generate markdown format
-                currentMarkdown = formatMarkdownFromJson(word, translations, sentences);
-
-                resultDisplay->setHtml(result);
-                statusLabel->setText("Found - " + QDateTime::currentDateTime().toString("hh:mm:ss"));
-
-                // Save to history
-                saveWordToHistory(word, result);
-                refreshHistoryList();
-
-                // Auto-copy to clipboard
-                copyToClipboard();
-                return;
-            }
-        }
-    }
-
-    // Fallback: if JSON parsing fails, use HTML parsing
-    resultDisplay->setText("Could not extract dictionary data from OpenRussian.org");
-    statusLabel->setText("Parse error");
-}
-
-QString MainWindow::formatMarkdownFromJson(const QString &word, const QJsonArray &translations, const QJsonArray &sentences)
+void MainWindow::displayWordEntry(const QString &word, const QJsonObject &wordData)
 {
-    QString markdown;
-    markdown += QString("# <font color='red'>%1</font>\n\n").arg(word);
+    qint64 renderStarted = PerfStats::now();
 
-    // Translations section
-    markdown += "## Translations\n\n";
+    QJsonArray translations = wordData["translations"].toArray();
+
+    // Format for display
+    QString result;
+    result += QString("<h2 style='color: red;'>%1</h2>").arg(word);
+    result += "<h3 style='color: #2E86AB; background-color: #f0f0f0; padding: 5px;'>Translations</h3>";
+    result += "<ul>";
 
     // Use a counter instead of indexOf
     int translationIndex = 1;
@@ -577,50 +994,65 @@ QString MainWindow::formatMarkdownFromJson(const QString &word, const QJsonArray
 
         if (!tls.isEmpty()) {
             QString translationText = tls[0].toString();
-
-            markdown += QString("**%1. %2**").arg(translationIndex).arg(translationText);
+            result += QString("<li><b>%1</b> - %2").arg(translationIndex).arg(translationText);
 
             // Add example if available
             QString exampleRu = translation["exampleRu"].toString();
             QString exampleTl = translation["exampleTl"].toString();
             if (!exampleRu.isEmpty() && !exampleTl.isEmpty()) {
-                markdown += QString("\n   *Example: %1 → %2*").arg(exampleRu, exampleTl);
+                result += QString("<br><i>Example: %1 - %2</i>").arg(exampleRu, exampleTl);
             }
 
-            markdown += "\n\n";
+            result += "</li>";
             translationIndex++;
         }
     }
+    result += "</ul>";
 
-    // Examples section
+    // Extract examples
+    QJsonArray sentences = wordData["sentences"].toArray();
     if (!sentences.isEmpty()) {
-        markdown += "## Examples\n\n";
+        result += "<h3 style='color: #2E86AB; background-color: #f0f0f0; padding: 5px;'>Examples</h3>";
+        result += "<ul>";
 
         for (int i = 0; i < sentences.size() && i < 10; ++i) {
             QJsonObject sentence = sentences[i].toObject();
             QString ru = sentence["ru"].toString();
             QString tl = sentence["tl"].toString();
 
-            // Clean up the text
-            ru.remove(QRegularExpression("<[^>]*>"));
-            ru.replace("&#x27;", "'");
-            ru = ru.simplified();
-
-            tl.remove(QRegularExpression("<[^>]*>"));
-            tl.replace("&#x27;", "'");
-            tl = tl.simplified();
-
-            markdown += QString("* **Russian:** %1\n").arg(ru);
-            markdown += QString("  **English:** %1\n\n").arg(tl);
+            result += QString("<li><b>Russian:</b> %1<br><b>English:</b> %2</li>").arg(ru, tl);
         }
+        result += "</ul>";
     }
 
-    return markdown;
+    currentDefinition = result;
+
+    // Generate markdown format
+    currentMarkdown = OpenRussian::formatMarkdown(word, wordData);
+
+    resultDisplay->setHtml(result);
+    statusLabel->setText("Found - " + QDateTime::currentDateTime().toString("hh:mm:ss"));
+
+    PerfStats::instance().recordSince(PerfStats::LookupRender, renderStarted);
+}
+
+void MainWindow::showWordEntry(const QString &word, const QJsonObject &wordData)
+{
+    displayWordEntry(word, wordData);
+
+    // Save to history
+    saveWordToHistory(word, currentDefinition);
+    refreshHistoryList();
+    cacheWarmer->addRecentWord(word);
+
+    // Auto-copy to clipboard
+    copyToClipboard();
 }
 
 void MainWindow::copyToClipboard()
 {
     if (!currentMarkdown.isEmpty()) {
+        clipboardLookup->ignoreText(currentMarkdown);
         QApplication::clipboard()->setText(currentMarkdown);
         statusLabel->setText("Markdown copied to clipboard - " + QDateTime::currentDateTime().toString("hh:mm:ss"));
     }
@@ -648,11 +1080,176 @@ void MainWindow::copyHistoryToClipboard()
         plainText.replace(QRegularExpression("Examples"), "**Examples**");
         markdown += plainText;
 
+        clipboardLookup->ignoreText(markdown);
         QApplication::clipboard()->setText(markdown);
         statusLabel->setText("History markdown copied to clipboard - " + QDateTime::currentDateTime().toString("hh:mm:ss"));
     }
 }
 
+void MainWindow::exportHistory()
+{
+    // Optional filters: a date range and a pattern the word has to match
+    QDialog filterDialog(this);
+    filterDialog.setWindowTitle("Export History");
+    QCheckBox *sinceCheckbox = new QCheckBox("From");
+    QDateEdit *sinceEdit = new QDateEdit(QDate::currentDate().addMonths(-1));
+    QCheckBox *untilCheckbox = new QCheckBox("Until");
+    QDateEdit *untilEdit = new QDateEdit(QDate::currentDate());
+    for (QDateEdit *edit : {sinceEdit, untilEdit}) {
+        edit->setCalendarPopup(true);
+        edit->setDisplayFormat("yyyy-MM-dd");
+        edit->setEnabled(false);
+    }
+    connect(sinceCheckbox, &QCheckBox::toggled, sinceEdit, &QWidget::setEnabled);
+    connect(untilCheckbox, &QCheckBox::toggled, untilEdit, &QWidget::setEnabled);
+    QLineEdit *matchEdit = new QLineEdit();
+    matchEdit->setPlaceholderText("Regular expression, e.g. ^по");
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    connect(buttons, &QDialogButtonBox::accepted, &filterDialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &filterDialog, &QDialog::reject);
+
+    QFormLayout *filterLayout = new QFormLayout(&filterDialog);
+    filterLayout->addRow(sinceCheckbox, sinceEdit);
+    filterLayout->addRow(untilCheckbox, untilEdit);
+    filterLayout->addRow("Words matching", matchEdit);
+    filterLayout->addRow(buttons);
+    if (filterDialog.exec() != QDialog::Accepted) return;
+
+    QRegularExpression wordFilter(matchEdit->text());
+    if (!wordFilter.isValid()) {
+        statusLabel->setText("Export failed - invalid pattern: " + wordFilter.errorString());
+        return;
+    }
+
+    QString fileName = QFileDialog::getSaveFileName(this, "Export History", "russian_word_history.md",
+                                                    "Markdown (*.md);;JSON Lines (*.jsonl);;CSV (*.csv);;Anki notes (*.txt)");
+    if (fileName.isEmpty()) return;
+
+    HistoryExporter *exporter = new HistoryExporter(historyFile, entryCache->directory(), this);
+    exporter->setFormat(HistoryExporter::formatForFileName(fileName));
+    if (sinceCheckbox->isChecked()) {
+        exporter->setSince(QDateTime(sinceEdit->date(), QTime(0, 0)));
+    }
+    if (untilCheckbox->isChecked()) {
+        exporter->setUntil(QDateTime(untilEdit->date(), QTime(23, 59, 59)));
+    }
+    if (!matchEdit->text().isEmpty()) {
+        exporter->setWordFilter(wordFilter);
+    }
+
+    // Rendering runs on the thread pool; the window stays responsive meanwhile
+    QProgressDialog *progress = new QProgressDialog("Exporting history...", QString(), 0, 100, this);
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setMinimumDuration(500);
+    progress->setValue(0);
+    connect(exporter, &HistoryExporter::progress, progress, [progress](qint64 bytesRead, qint64 totalBytes) {
+        progress->setValue(totalBytes > 0 ? int(bytesRead * 100 / totalBytes) : 0);
+    });
+
+    QElapsedTimer timer;
+    timer.start();
+    QFutureWatcher<bool> *watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, exporter, progress, fileName, timer]() {
+        progress->close();
+        progress->deleteLater();
+        exportHistoryButton->setEnabled(true);
+
+        if (watcher->result()) {
+            statusLabel->setText(QString("Exported %1 history entries to %2 in %3 ms")
+                                     .arg(exporter->exportedCount()).arg(QDir::toNativeSeparators(fileName)).arg(timer.elapsed()));
+        } else {
+            statusLabel->setText("Export failed - " + exporter->errorString());
+        }
+        exporter->deleteLater();
+        watcher->deleteLater();
+    });
+
+    exportHistoryButton->setEnabled(false);
+    statusLabel->setText("Exporting history...");
+    watcher->setFuture(QtConcurrent::run([exporter, fileName]() {
+        return exporter->exportTo(fileName);
+    }));
+}
+
+void MainWindow::syncWithDirectory()
+{
+    QString directory = QFileDialog::getExistingDirectory(this, "Sync Folder");
+    if (directory.isEmpty()) return;
+
+    SyncBundle *bundle = new SyncBundle(directory, historyFile, entryCache->directory(), "word_audio");
+
+    // Import and export run on the thread pool; the modal dialog keeps lookups
+    // from writing the history while it is being merged. Background writers
+    // to word_cache and word_audio stop until the sync is done.
+    syncInProgress = true;
+    idleTimer->stop();
+    cacheWarmer->abort();
+    clipboardLookup->setEnabled(false);
+    entryCache->setWritesHeld(true);
+
+    QProgressDialog *progress = new QProgressDialog("Syncing...", QString(), 0, 0, this);
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setMinimumDuration(500);
+    progress->setAutoReset(false);
+    progress->setAutoClose(false);
+    progress->setValue(0);
+    QPointer<QProgressDialog> progressGuard(progress);
+    bundle->setProgressHandler([this, progressGuard](const QString &stage, int done, int total) {
+        QMetaObject::invokeMethod(this, [progressGuard, stage, done, total]() {
+            if (!progressGuard) return;
+            progressGuard->setLabelText(QString("%1 %2 of %3 files...").arg(stage).arg(done).arg(total));
+            progressGuard->setMaximum(total);
+            progressGuard->setValue(done);
+        }, Qt::QueuedConnection);
+    });
+
+    QElapsedTimer timer;
+    timer.start();
+    QFutureWatcher<bool> *watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, bundle, progress, timer]() {
+        progress->close();
+        progress->deleteLater();
+        syncButton->setEnabled(true);
+
+        refreshHistoryList();
+
+        // Entries stored during the sync are written first, so reloading reads what is on disk
+        entryCache->setWritesHeld(false);
+
+        // Received entries reach the reverse index and the concordance like fetched ones
+        for (const QString &filePath : bundle->importedEntryFiles()) {
+            entryCache->reloadFile(filePath);
+        }
+
+        syncInProgress = false;
+        clipboardLookup->setEnabled(clipboardWatchCheckbox->isChecked());
+        if (cacheWarmer->isEnabled() && !isActiveWindow()) {
+            cacheWarmer->resume();
+        } else if (cacheWarmer->isEnabled()) {
+            idleTimer->start();
+        }
+
+        SyncBundle::Stats stats = bundle->stats();
+        QString summary = QString("%1 files and %2 history records received, %3 of %4 files sent (%5 KB) in %6 ms")
+                              .arg(stats.filesImported).arg(stats.historyRecordsAdded)
+                              .arg(stats.filesChanged).arg(stats.filesScanned)
+                              .arg(stats.bytesWritten / 1024).arg(timer.elapsed());
+        statusLabel->setText(watcher->result() ? "Synced - " + summary : "Sync incomplete - " + bundle->errorString());
+
+        delete bundle;
+        watcher->deleteLater();
+    });
+
+    syncButton->setEnabled(false);
+    statusLabel->setText("Syncing with " + QDir::toNativeSeparators(directory) + "...");
+    watcher->setFuture(QtConcurrent::run([bundle]() {
+        // Import first so the merged history goes out with this export
+        bool ok = bundle->importBundles();
+        return bundle->exportBundle() && ok;
+    }));
+}
+
 void MainWindow::saveWordToHistory(const QString &russianWord, const QString &definition)
 {
     QFile file(historyFile);
@@ -707,6 +1304,8 @@ void MainWindow::refreshHistoryList()
         }
         file.close();
     }
+
+    PerfStats::instance().set(PerfStats::HistorySize, historyList->count());
 }
 
 void MainWindow::onHistoryItemClicked(QListWidgetItem *item)
@@ -728,9 +1327,7 @@ void MainWindow::onHistoryItemClicked(QListWidgetItem *item)
 void MainWindow::playAudioForWord(const QString &word)
 {
     // Check if audio file exists locally in word_audio folder
-    QString safeWord = word;
-    safeWord.replace(QRegularExpression("[^a-zA-Z0-9а-яА-ЯёЁ]"), "_");
-    QString localAudioFile = QString("word_audio/%1_ru.mp3").arg(safeWord);
+    QString localAudioFile = TextToSpeech::localFilePath(word, "ru");
 
     QFile file(localAudioFile);
     if (file.exists()) {
@@ -11,14 +11,30 @@
 #include <QLabel>
 #include <QListWidget>
 #include <QHash>
+#include <QSet>
 #include <QMediaPlayer>
 #include <QCheckBox>
 #include <QProgressBar>
+#include <QDockWidget>
+#include <QPlainTextEdit>
+#include <QTimer>
+#include <QFutureWatcher>
+#include <QJsonObject>
 
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
 #include <QAudioOutput>
 #endif
 
+class CacheWarmer;
+class ClipboardLookup;
+class Concordance;
+class EntryCache;
+class LocalDictionaryBackend;
+class LookupPopup;
+class OpenRussianBackend;
+class PhraseLookup;
+class ReverseIndex;
+
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
@@ -27,18 +43,45 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+    // Drive the lookup pipeline without user input (used by the load-test harness)
+    void lookupWord(const QString &word);
+    void setAutoPlay(bool enabled);
+    void setAudioPlaybackEnabled(bool enabled);
+
+    CacheWarmer *warmer() const;
+    void setWarmCache(bool enabled);
+    void setStatsFile(const QString &filePath, int intervalSeconds);
+    void setClipboardWatch(bool enabled);
+
+signals:
+    void lookupFinished(const QString &word, bool found);
+    void audioFinished(const QString &word, bool ok);
+
 protected:
     bool event(QEvent *event) override;
     void showEvent(QShowEvent *event) override;
 
 private slots:
     void onLookupWord();
-    void onNetworkReply(QNetworkReply *reply);
+    void onBackendLookupFinished(const QString &word, bool found, const QJsonObject &wordData, const QString &errorString);
     void onTtsReply(QNetworkReply *reply);
     void onTextChanged(const QString &text);
     void onHistoryItemClicked(QListWidgetItem *item);
     void copyToClipboard();
     void copyHistoryToClipboard();
+    void exportHistory();
+    void syncWithDirectory();
+    void onPhraseWordResolved(const QString &word, const QJsonObject &wordData, bool found);
+    void onPhraseLookupFinished();
+    void onWarmCacheToggled(bool checked);
+    void onReverseModeToggled(bool checked);
+    void onClipboardWordResolved(const QString &word, const QJsonObject &wordData, bool found);
+    void onPopupClicked(const QString &word);
+    void onDictionariesLoaded();
+    void searchExamples();
+    void onWarmerProgress();
+    void refreshStatsDock();
+    void writeStatsFile();
 
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
     void onMediaStatusChanged(QMediaPlayer::MediaStatus status);
@@ -54,29 +97,62 @@ private:
     void playAudioFile(const QString &filePath);
     void playAudioForWord(const QString &word);
     QString convertToRussian(const QString &input);
-    void parseOpenRussianResponse(const QByteArray &data, const QString &word);
-    QString formatMarkdownFromJson(const QString &word, const QJsonArray &translations, const QJsonArray &sentences);
+    void displayWordEntry(const QString &word, const QJsonObject &wordData);
+    void showWordEntry(const QString &word, const QJsonObject &wordData);
+    void lookupPhrase(const QStringList &tokens);
+    void lookupEnglish(const QString &query);
+    void renderPhraseGloss();
     void saveWordToHistory(const QString &russianWord, const QString &definition);
     void loadHistory();
     void refreshHistoryList();
+    void noteUserActivity();
 
     // UI Components
     QSplitter *mainSplitter;
     QLineEdit *wordInput;
     QCheckBox *autoPlayCheckbox;
+    QCheckBox *warmCacheCheckbox;
+    QCheckBox *reverseModeCheckbox;
+    QCheckBox *clipboardWatchCheckbox;
     QProgressBar *lookupProgressBar;
     QProgressBar *audioProgressBar;
     QTextEdit *resultDisplay;
     QTextEdit *historyDetailDisplay;
     QListWidget *historyList;
     QPushButton *lookupButton;
+    QPushButton *examplesButton;
     QPushButton *copyButton;
     QPushButton *copyHistoryButton;
+    QPushButton *exportHistoryButton;
+    QPushButton *syncButton;
+    QPushButton *statsButton;
+    QDockWidget *statsDock;
+    QPlainTextEdit *statsDisplay;
     QLabel *statusLabel;
 
+    // Dictionaries
+    OpenRussianBackend *openRussianBackend;
+    QList<LocalDictionaryBackend *> localBackends;
+    QFutureWatcher<QList<LocalDictionaryBackend *>> *dictionaryLoader;
+
     // Network
-    QNetworkAccessManager *networkManager;
     QNetworkAccessManager *ttsNetworkManager;
+    PhraseLookup *phraseLookup;
+    ClipboardLookup *clipboardLookup;
+    LookupPopup *lookupPopup;
+
+    // Cache
+    EntryCache *entryCache;
+    CacheWarmer *cacheWarmer;
+    ReverseIndex *reverseIndex;
+    Concordance *concordance;
+    QTimer *idleTimer;
+
+    // Statistics
+    QTimer *statsRefreshTimer;
+    QTimer *statsFileTimer;
+    QString statsFile;
+    qint64 playbackRequestedAt;
 
     // Media
     QMediaPlayer *mediaPlayer;
@@ -89,7 +165,17 @@ private:
     QString currentWord;
     QString currentMarkdown;
     QString currentDefinition;
+    QJsonObject localEntry;
     bool isConverting;
+    bool audioPlaybackEnabled;
+    bool syncInProgress;
+
+    // Phrase mode: tokens as typed, gloss per normalized word (null = pending)
+    // and the words no dictionary knows
+    QStringList phraseTokens;
+    QHash<QString, QString> phraseGlosses;
+    QSet<QString> phraseMissing;
+    QTimer *phraseRenderTimer;
 };
 
 #endif // MAINWINDOW_H
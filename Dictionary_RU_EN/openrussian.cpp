@@ -0,0 +1,156 @@
+#include "openrussian.h"
+#include "lazyjson.h"
+#include <QJsonArray>
+#include <QRegularExpression>
+
+namespace OpenRussian
+{
+
+namespace
+{
+    // Use en.openrussian.org - the correct English interface
+    QString siteUrl = "https://en.openrussian.org";
+}
+
+QString baseUrl()
+{
+    return siteUrl;
+}
+
+void setBaseUrl(const QString &url)
+{
+    siteUrl = url;
+    while (siteUrl.endsWith('/')) {
+        siteUrl.chop(1);
+    }
+}
+
+QUrl lookupUrl(const QString &word)
+{
+    return QUrl(QString("%1/ru/%2").arg(siteUrl, word));
+}
+
+bool extractWordData(const QByteArray &html, QJsonObject *wordData)
+{
+    // Find the JSON payload of the __NEXT_DATA__ script without decoding the page
+    static const QByteArray scriptStart = "<script id=\"__NEXT_DATA__\" type=\"application/json\">";
+    int begin = html.indexOf(scriptStart);
+    if (begin < 0) {
+        return false;
+    }
+    begin += scriptStart.size();
+    int end = html.indexOf("</script>", begin);
+    if (end < 0) {
+        return false;
+    }
+
+    LazyJson json(html.constData() + begin, end - begin);
+    LazyJson::Value word = json.root()["props"]["pageProps"]["info"]["words"][0];
+    if (!word.isObject()) {
+        return false;
+    }
+
+    // Decode only the fields the application reads, the rest of the page state is skipped
+    QJsonObject result;
+    for (const char *key : {"ru", "accented"}) {
+        LazyJson::Value value = word[key];
+        if (value.isString()) result[key] = value.toString();
+    }
+
+    QJsonArray translations;
+    for (LazyJson::Value item = word["translations"].first(); item.isValid(); item = item.next()) {
+        QJsonObject translation;
+        translation["tls"] = item["tls"].toJsonValue().toArray();
+        for (const char *key : {"info", "exampleRu", "exampleTl"}) {
+            translation[key] = item[key].toString();
+        }
+        translations.append(translation);
+    }
+    result["translations"] = translations;
+
+    QJsonArray sentences;
+    for (LazyJson::Value item = word["sentences"].first(); item.isValid(); item = item.next()) {
+        QJsonObject sentence;
+        sentence["ru"] = item["ru"].toString();
+        sentence["tl"] = item["tl"].toString();
+        sentences.append(sentence);
+    }
+    result["sentences"] = sentences;
+
+    *wordData = result;
+    return true;
+}
+
+QString firstTranslation(const QJsonObject &wordData)
+{
+    const QJsonArray translations = wordData["translations"].toArray();
+    for (const QJsonValue &transValue : translations) {
+        QJsonArray tls = transValue.toObject()["tls"].toArray();
+        if (!tls.isEmpty()) {
+            return tls[0].toString();
+        }
+    }
+    return QString();
+}
+
+QString formatMarkdown(const QString &word, const QJsonObject &wordData)
+{
+    QJsonArray translations = wordData["translations"].toArray();
+    QJsonArray sentences = wordData["sentences"].toArray();
+
+    QString markdown;
+    markdown += QString("# <font color='red'>%1</font>\n\n").arg(word);
+
+    // Translations section
+    markdown += "## Translations\n\n";
+
+    // Use a counter instead of indexOf
+    int translationIndex = 1;
+    for (const QJsonValue &transValue : translations) {
+        QJsonObject translation = transValue.toObject();
+        QJsonArray tls = translation["tls"].toArray();
+
+        if (!tls.isEmpty()) {
+            QString translationText = tls[0].toString();
+
+            markdown += QString("**%1. %2**").arg(translationIndex).arg(translationText);
+
+            // Add example if available
+            QString exampleRu = translation["exampleRu"].toString();
+            QString exampleTl = translation["exampleTl"].toString();
+            if (!exampleRu.isEmpty() && !exampleTl.isEmpty()) {
+                markdown += QString("\n   *Example: %1 → %2*").arg(exampleRu, exampleTl);
+            }
+
+            markdown += "\n\n";
+            translationIndex++;
+        }
+    }
+
+    // Examples section
+    if (!sentences.isEmpty()) {
+        markdown += "## Examples\n\n";
+
+        for (int i = 0; i < sentences.size() && i < 10; ++i) {
+            QJsonObject sentence = sentences[i].toObject();
+            QString ru = sentence["ru"].toString();
+            QString tl = sentence["tl"].toString();
+
+            // Clean up the text
+            ru.remove(QRegularExpression("<[^>]*>"));
+            ru.replace("&#x27;", "'");
+            ru = ru.simplified();
+
+            tl.remove(QRegularExpression("<[^>]*>"));
+            tl.replace("&#x27;", "'");
+            tl = tl.simplified();
+
+            markdown += QString("* **Russian:** %1\n").arg(ru);
+            markdown += QString("  **English:** %1\n\n").arg(tl);
+        }
+    }
+
+    return markdown;
+}
+
+} // namespace OpenRussian
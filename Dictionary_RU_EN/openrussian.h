@@ -0,0 +1,31 @@
+#ifndef OPENRUSSIAN_H
+#define OPENRUSSIAN_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QString>
+#include <QUrl>
+
+// Helpers shared by everything that talks to en.openrussian.org
+namespace OpenRussian
+{
+    // Site root, "https://en.openrussian.org" unless overridden (e.g. by a local mock server)
+    QString baseUrl();
+    void setBaseUrl(const QString &url);
+
+    // Page URL for a Russian headword
+    QUrl lookupUrl(const QString &word);
+
+    // Extract props.pageProps.info.words[0] from the __NEXT_DATA__ script of a page:
+    // its headword, translations (tls, info, exampleRu, exampleTl) and sentences (ru, tl).
+    // Returns false if the page does not contain a dictionary entry.
+    bool extractWordData(const QByteArray &html, QJsonObject *wordData);
+
+    // First English translation of an entry, or an empty string
+    QString firstTranslation(const QJsonObject &wordData);
+
+    // Markdown rendering of an entry, as copied to the clipboard
+    QString formatMarkdown(const QString &word, const QJsonObject &wordData);
+}
+
+#endif // OPENRUSSIAN_H
@@ -0,0 +1,62 @@
+#include "openrussianbackend.h"
+#include "entrycache.h"
+#include "openrussian.h"
+#include "perfstats.h"
+#include <QNetworkRequest>
+
+OpenRussianBackend::OpenRussianBackend(EntryCache *cache, QObject *parent)
+    : DictionaryBackend(parent)
+    , entryCache(cache)
+    , networkManager(new QNetworkAccessManager(this))
+{
+    connect(networkManager, &QNetworkAccessManager::finished, this, &OpenRussianBackend::onNetworkReply);
+}
+
+QString OpenRussianBackend::name() const
+{
+    return "OpenRussian.org";
+}
+
+bool OpenRussianBackend::isLocal() const
+{
+    return false;
+}
+
+void OpenRussianBackend::lookup(const QString &word)
+{
+    QNetworkReply *reply = networkManager->get(QNetworkRequest(OpenRussian::lookupUrl(word)));
+    reply->setProperty("word", word);
+    reply->setProperty("started", PerfStats::now());
+    PerfStats::instance().add(PerfStats::InFlightRequests);
+}
+
+void OpenRussianBackend::onNetworkReply(QNetworkReply *reply)
+{
+    reply->deleteLater();
+
+    PerfStats &stats = PerfStats::instance();
+    stats.add(PerfStats::InFlightRequests, -1);
+    stats.recordSince(PerfStats::LookupFetch, reply->property("started").toLongLong());
+
+    QString word = reply->property("word").toString();
+    if (reply->error() != QNetworkReply::NoError) {
+        emit lookupFinished(word, false, QJsonObject(), "Word not found or network error: " + reply->errorString());
+        return;
+    }
+
+    QByteArray data = reply->readAll();
+    stats.add(PerfStats::BytesDownloaded, data.size());
+
+    qint64 parseStarted = PerfStats::now();
+    QJsonObject wordData;
+    bool parsed = OpenRussian::extractWordData(data, &wordData);
+    stats.recordSince(PerfStats::LookupParse, parseStarted);
+
+    if (!parsed) {
+        emit lookupFinished(word, false, QJsonObject(), "Could not extract dictionary data from OpenRussian.org");
+        return;
+    }
+
+    entryCache->store(word, wordData);
+    emit lookupFinished(word, true, wordData, QString());
+}
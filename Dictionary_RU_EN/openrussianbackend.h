@@ -0,0 +1,30 @@
+#ifndef OPENRUSSIANBACKEND_H
+#define OPENRUSSIANBACKEND_H
+
+#include "dictionarybackend.h"
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+
+class EntryCache;
+
+// Fetches entries from en.openrussian.org, storing parsed entries in the cache
+class OpenRussianBackend : public DictionaryBackend
+{
+    Q_OBJECT
+
+public:
+    OpenRussianBackend(EntryCache *cache, QObject *parent = nullptr);
+
+    QString name() const override;
+    bool isLocal() const override;
+    void lookup(const QString &word) override;
+
+private slots:
+    void onNetworkReply(QNetworkReply *reply);
+
+private:
+    EntryCache *entryCache;
+    QNetworkAccessManager *networkManager;
+};
+
+#endif // OPENRUSSIANBACKEND_H
@@ -0,0 +1,276 @@
+#include "perfstats.h"
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QtAlgorithms>
+
+namespace
+{
+    struct MonotonicClock
+    {
+        MonotonicClock() { timer.start(); }
+        QElapsedTimer timer;
+    };
+}
+
+LatencyHistogram::LatencyHistogram()
+    : total(0)
+    , sumMicroseconds(0)
+    , maxMicroseconds(0)
+{
+    for (std::atomic<qint64> &bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+int LatencyHistogram::bucketFor(quint64 microseconds)
+{
+    if (microseconds < 32) {
+        return int(microseconds);
+    }
+
+    // The highest bit selects the power of two, the next four bits the sub-bucket
+    int highestBit = 63 - int(qCountLeadingZeroBits(microseconds));
+    int subBucket = int((microseconds >> (highestBit - 4)) & 15);
+    return qMin(BucketCount - 1, 32 + (highestBit - 5) * 16 + subBucket);
+}
+
+quint64 LatencyHistogram::bucketValue(int bucket)
+{
+    if (bucket < 32) {
+        return quint64(bucket);
+    }
+
+    // Middle of the bucket's range
+    int highestBit = (bucket - 32) / 16 + 5;
+    quint64 subBucket = quint64((bucket - 32) % 16);
+    quint64 lower = (16 + subBucket) << (highestBit - 4);
+    quint64 width = quint64(1) << (highestBit - 4);
+    return lower + width / 2;
+}
+
+void LatencyHistogram::record(qint64 nanoseconds)
+{
+    qint64 microseconds = qMax<qint64>(0, nanoseconds / 1000);
+
+    buckets[bucketFor(quint64(microseconds))].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sumMicroseconds.fetch_add(microseconds, std::memory_order_relaxed);
+
+    qint64 currentMax = maxMicroseconds.load(std::memory_order_relaxed);
+    while (microseconds > currentMax
+           && !maxMicroseconds.compare_exchange_weak(currentMax, microseconds, std::memory_order_relaxed)) {
+    }
+}
+
+qint64 LatencyHistogram::count() const
+{
+    return total.load(std::memory_order_relaxed);
+}
+
+double LatencyHistogram::meanMs() const
+{
+    qint64 n = count();
+    return n > 0 ? sumMicroseconds.load(std::memory_order_relaxed) / 1000.0 / n : 0.0;
+}
+
+double LatencyHistogram::maxMs() const
+{
+    return maxMicroseconds.load(std::memory_order_relaxed) / 1000.0;
+}
+
+double LatencyHistogram::percentileMs(double percentile) const
+{
+    qint64 n = count();
+    if (n == 0) return 0.0;
+
+    qint64 rank = qMax<qint64>(1, qint64(percentile * n + 0.5));
+    qint64 seen = 0;
+    for (int i = 0; i < BucketCount; ++i) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return qMin(double(bucketValue(i)) / 1000.0, maxMs());
+        }
+    }
+    return maxMs();
+}
+
+PerfStats::PerfStats()
+{
+    for (std::atomic<qint64> &counter : counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+}
+
+PerfStats &PerfStats::instance()
+{
+    static PerfStats stats;
+    return stats;
+}
+
+qint64 PerfStats::now()
+{
+    static const MonotonicClock clock;
+    return clock.timer.nsecsElapsed();
+}
+
+void PerfStats::record(Timing timing, qint64 nanoseconds)
+{
+    timings[timing].record(nanoseconds);
+}
+
+void PerfStats::recordSince(Timing timing, qint64 startNanoseconds)
+{
+    timings[timing].record(now() - startNanoseconds);
+}
+
+void PerfStats::add(Counter counter, qint64 delta)
+{
+    counters[counter].fetch_add(delta, std::memory_order_relaxed);
+}
+
+void PerfStats::set(Counter counter, qint64 value)
+{
+    counters[counter].store(value, std::memory_order_relaxed);
+}
+
+const LatencyHistogram &PerfStats::histogram(Timing timing) const
+{
+    return timings[timing];
+}
+
+qint64 PerfStats::value(Counter counter) const
+{
+    return counters[counter].load(std::memory_order_relaxed);
+}
+
+QString PerfStats::timingName(Timing timing)
+{
+    switch (timing) {
+    case LookupFetch: return "lookup_fetch";
+    case LookupParse: return "lookup_parse";
+    case LookupRender: return "lookup_render";
+    case TtsDownload: return "tts_download";
+    case PlaybackStart: return "playback_start";
+    default: return QString();
+    }
+}
+
+QString PerfStats::counterName(Counter counter)
+{
+    switch (counter) {
+    case CacheHits: return "cache_hits";
+    case CacheMisses: return "cache_misses";
+    case BytesDownloaded: return "bytes_downloaded";
+    case HistorySize: return "history_size";
+    case InFlightRequests: return "in_flight_requests";
+    default: return QString();
+    }
+}
+
+QString PerfStats::toText() const
+{
+    QString text = QString("%1 %2 %3 %4 %5 %6\n")
+            .arg("", -15).arg("count", 7).arg("p50 ms", 9).arg("p90 ms", 9).arg("p99 ms", 9).arg("max ms", 9);
+    for (int i = 0; i < TimingCount; ++i) {
+        const LatencyHistogram &h = timings[i];
+        text += QString("%1 %2 %3 %4 %5 %6\n")
+                .arg(timingName(Timing(i)), -15).arg(h.count(), 7)
+                .arg(h.percentileMs(0.50), 9, 'f', 2).arg(h.percentileMs(0.90), 9, 'f', 2)
+                .arg(h.percentileMs(0.99), 9, 'f', 2).arg(h.maxMs(), 9, 'f', 2);
+    }
+
+    text += "\n";
+    qint64 hits = value(CacheHits);
+    qint64 lookups = hits + value(CacheMisses);
+    for (int i = 0; i < CounterCount; ++i) {
+        text += QString("%1 %2\n").arg(counterName(Counter(i)), -20).arg(value(Counter(i)));
+    }
+    text += QString("%1 %2%\n").arg("cache_hit_rate", -20)
+            .arg(lookups > 0 ? 100.0 * hits / lookups : 0.0, 0, 'f', 1);
+    return text;
+}
+
+QJsonObject PerfStats::toJson() const
+{
+    QJsonObject root;
+    root["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+
+    QJsonObject histograms;
+    for (int i = 0; i < TimingCount; ++i) {
+        const LatencyHistogram &h = timings[i];
+        QJsonObject entry;
+        entry["count"] = double(h.count());
+        entry["mean_ms"] = h.meanMs();
+        entry["p50_ms"] = h.percentileMs(0.50);
+        entry["p90_ms"] = h.percentileMs(0.90);
+        entry["p99_ms"] = h.percentileMs(0.99);
+        entry["max_ms"] = h.maxMs();
+        histograms[timingName(Timing(i))] = entry;
+    }
+    root["timings"] = histograms;
+
+    QJsonObject values;
+    for (int i = 0; i < CounterCount; ++i) {
+        values[counterName(Counter(i))] = double(value(Counter(i)));
+    }
+    root["counters"] = values;
+
+    return root;
+}
+
+QStringList PerfStats::csvHeader()
+{
+    QStringList header;
+    header << "timestamp";
+    for (int i = 0; i < TimingCount; ++i) {
+        QString name = timingName(Timing(i));
+        header << name + "_count" << name + "_p50_ms" << name + "_p99_ms" << name + "_max_ms";
+    }
+    for (int i = 0; i < CounterCount; ++i) {
+        header << counterName(Counter(i));
+    }
+    return header;
+}
+
+QStringList PerfStats::csvRow() const
+{
+    QStringList row;
+    row << QDateTime::currentDateTime().toString(Qt::ISODate);
+    for (int i = 0; i < TimingCount; ++i) {
+        const LatencyHistogram &h = timings[i];
+        row << QString::number(h.count())
+            << QString::number(h.percentileMs(0.50), 'f', 3)
+            << QString::number(h.percentileMs(0.99), 'f', 3)
+            << QString::number(h.maxMs(), 'f', 3);
+    }
+    for (int i = 0; i < CounterCount; ++i) {
+        row << QString::number(value(Counter(i)));
+    }
+    return row;
+}
+
+bool PerfStats::writeToFile(const QString &filePath) const
+{
+    if (filePath.endsWith(".csv", Qt::CaseInsensitive)) {
+        bool newFile = !QFileInfo::exists(filePath) || QFileInfo(filePath).size() == 0;
+        QFile file(filePath);
+        if (!file.open(QIODevice::Append | QIODevice::Text)) {
+            return false;
+        }
+        if (newFile) {
+            file.write(csvHeader().join(',').toUtf8() + "\n");
+        }
+        file.write(csvRow().join(',').toUtf8() + "\n");
+        return true;
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    file.write(QJsonDocument(toJson()).toJson());
+    return true;
+}
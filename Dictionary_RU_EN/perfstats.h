@@ -0,0 +1,89 @@
+#ifndef PERFSTATS_H
+#define PERFSTATS_H
+
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+
+// Latency histogram with HDR-style log-linear buckets: exact below 32 us,
+// then 16 sub-buckets per power of two (about 6% precision) up to 2^41 us (~25 days).
+// Recording is a handful of relaxed atomic increments and never locks.
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    void record(qint64 nanoseconds);
+
+    qint64 count() const;
+    double meanMs() const;
+    double maxMs() const;
+    double percentileMs(double percentile) const;
+
+private:
+    static const int BucketCount = 32 + 36 * 16;
+
+    static int bucketFor(quint64 microseconds);
+    static quint64 bucketValue(int bucket);
+
+    std::atomic<qint64> buckets[BucketCount];
+    std::atomic<qint64> total;
+    std::atomic<qint64> sumMicroseconds;
+    std::atomic<qint64> maxMicroseconds;
+};
+
+// Process-wide performance counters. Cheap enough to stay enabled permanently.
+class PerfStats
+{
+public:
+    enum Timing {
+        LookupFetch,
+        LookupParse,
+        LookupRender,
+        TtsDownload,
+        PlaybackStart,
+        TimingCount
+    };
+
+    enum Counter {
+        CacheHits,
+        CacheMisses,
+        BytesDownloaded,
+        HistorySize,
+        InFlightRequests,
+        CounterCount
+    };
+
+    static PerfStats &instance();
+
+    // Monotonic clock in nanoseconds, for measuring spans across events
+    static qint64 now();
+
+    void record(Timing timing, qint64 nanoseconds);
+    void recordSince(Timing timing, qint64 startNanoseconds);
+    void add(Counter counter, qint64 delta = 1);
+    void set(Counter counter, qint64 value);
+
+    const LatencyHistogram &histogram(Timing timing) const;
+    qint64 value(Counter counter) const;
+
+    static QString timingName(Timing timing);
+    static QString counterName(Counter counter);
+
+    QString toText() const;
+    QJsonObject toJson() const;
+    static QStringList csvHeader();
+    QStringList csvRow() const;
+
+    // Write a snapshot: overwrite with JSON, or append a line to a .csv file
+    bool writeToFile(const QString &filePath) const;
+
+private:
+    PerfStats();
+
+    LatencyHistogram timings[TimingCount];
+    std::atomic<qint64> counters[CounterCount];
+};
+
+#endif // PERFSTATS_H
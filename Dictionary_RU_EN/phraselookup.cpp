@@ -0,0 +1,133 @@
+#include "phraselookup.h"
+#include "dictionarybackend.h"
+#include "entrycache.h"
+#include "openrussian.h"
+#include "perfstats.h"
+#include <QNetworkRequest>
+#include <QRegularExpression>
+
+PhraseLookup::PhraseLookup(EntryCache *cache, QObject *parent)
+    : QObject(parent)
+    , entryCache(cache)
+    , networkManager(new QNetworkAccessManager(this))
+    , maxParallelRequests(6)
+{
+    connect(networkManager, &QNetworkAccessManager::finished, this, &PhraseLookup::onReply);
+}
+
+QStringList PhraseLookup::tokenize(const QString &text)
+{
+    // Letters (with stress marks), optionally joined by hyphens: "что-нибудь", "по-русски"
+    static const QRegularExpression tokenRegex("[\\p{L}\\x{0301}\\x{0300}]+(?:-[\\p{L}\\x{0301}\\x{0300}]+)*");
+
+    QStringList tokens;
+    QRegularExpressionMatchIterator it = tokenRegex.globalMatch(text);
+    while (it.hasNext()) {
+        tokens << it.next().captured(0);
+    }
+    return tokens;
+}
+
+QString PhraseLookup::normalizeToken(const QString &token)
+{
+    return EntryCache::normalizeWord(token);
+}
+
+void PhraseLookup::setMaxParallel(int maxParallel)
+{
+    maxParallelRequests = qMax(1, maxParallel);
+}
+
+void PhraseLookup::setLocalBackends(const QList<LocalDictionaryBackend *> &backends)
+{
+    localBackends = backends;
+}
+
+void PhraseLookup::start(const QStringList &words)
+{
+    abort();
+
+    PerfStats &stats = PerfStats::instance();
+    for (const QString &word : words) {
+        QJsonObject wordData;
+        bool cached = entryCache->lookup(word, &wordData);
+        stats.add(cached ? PerfStats::CacheHits : PerfStats::CacheMisses);
+
+        if (cached || LocalDictionaryBackend::findInAll(localBackends, word, &wordData)) {
+            emit wordResolved(word, wordData, true);
+        } else if (!pendingWords.contains(word)) {
+            pendingWords << word;
+        }
+    }
+
+    if (pendingWords.isEmpty()) {
+        emit finished();
+        return;
+    }
+
+    fetchNext();
+}
+
+void PhraseLookup::abort()
+{
+    pendingWords.clear();
+
+    // Take the replies out first: abort() emits finished() synchronously
+    QSet<QNetworkReply *> replies = activeReplies;
+    activeReplies.clear();
+    for (QNetworkReply *reply : replies) {
+        reply->abort();
+    }
+}
+
+bool PhraseLookup::isRunning() const
+{
+    return !pendingWords.isEmpty() || !activeReplies.isEmpty();
+}
+
+void PhraseLookup::fetchNext()
+{
+    while (activeReplies.size() < maxParallelRequests && !pendingWords.isEmpty()) {
+        QString word = pendingWords.takeFirst();
+        QNetworkReply *reply = networkManager->get(QNetworkRequest(OpenRussian::lookupUrl(word)));
+        reply->setProperty("word", word);
+        reply->setProperty("started", PerfStats::now());
+        activeReplies.insert(reply);
+        PerfStats::instance().add(PerfStats::InFlightRequests);
+    }
+}
+
+void PhraseLookup::onReply(QNetworkReply *reply)
+{
+    reply->deleteLater();
+
+    PerfStats &stats = PerfStats::instance();
+    stats.add(PerfStats::InFlightRequests, -1);
+
+    // Replies of an aborted phrase are no longer tracked
+    if (!activeReplies.remove(reply)) {
+        return;
+    }
+    stats.recordSince(PerfStats::LookupFetch, reply->property("started").toLongLong());
+
+    QString word = reply->property("word").toString();
+    QJsonObject wordData;
+    bool found = false;
+    if (reply->error() == QNetworkReply::NoError) {
+        QByteArray data = reply->readAll();
+        stats.add(PerfStats::BytesDownloaded, data.size());
+
+        qint64 parseStarted = PerfStats::now();
+        found = OpenRussian::extractWordData(data, &wordData);
+        stats.recordSince(PerfStats::LookupParse, parseStarted);
+    }
+    if (found) {
+        entryCache->store(word, wordData);
+    }
+    emit wordResolved(word, wordData, found);
+
+    fetchNext();
+    if (activeReplies.isEmpty() && pendingWords.isEmpty()) {
+        emit finished();
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef PHRASELOOKUP_H
+#define PHRASELOOKUP_H
+
+#include <QObject>
+#include <QJsonObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QSet>
+#include <QStringList>
+
+class EntryCache;
+class LocalDictionaryBackend;
+
+// Looks up every distinct word of a phrase: cached entries and local dictionaries
+// resolve immediately, misses are fetched from OpenRussian with a bounded number of parallel requests.
+class PhraseLookup : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PhraseLookup(EntryCache *cache, QObject *parent = nullptr);
+
+    // Split text into word tokens, keeping their original spelling
+    static QStringList tokenize(const QString &text);
+    // Lowercase a token and strip stress marks so it can be used as a headword
+    static QString normalizeToken(const QString &token);
+
+    void setMaxParallel(int maxParallel);
+    void setLocalBackends(const QList<LocalDictionaryBackend *> &backends);
+    void start(const QStringList &words);
+    void abort();
+    bool isRunning() const;
+
+signals:
+    void wordResolved(const QString &word, const QJsonObject &wordData, bool found);
+    void finished();
+
+private slots:
+    void onReply(QNetworkReply *reply);
+
+private:
+    void fetchNext();
+
+    EntryCache *entryCache;
+    QList<LocalDictionaryBackend *> localBackends;
+    QNetworkAccessManager *networkManager;
+    QStringList pendingWords;
+    QSet<QNetworkReply *> activeReplies;
+    int maxParallelRequests;
+};
+
+#endif // PHRASELOOKUP_H
@@ -0,0 +1,259 @@
+#include "reverseindex.h"
+#include "entrycache.h"
+#include <QJsonArray>
+#include <QRegularExpression>
+#include <QSet>
+#include <QtConcurrent>
+#include <algorithm>
+
+namespace
+{
+    bool isVowel(QChar c)
+    {
+        return QString("aeiouy").contains(c);
+    }
+
+    // "stopping" -> "stopp" -> "stop"
+    QString undouble(const QString &word)
+    {
+        int n = word.size();
+        if (n >= 3 && word[n - 1] == word[n - 2] && !isVowel(word[n - 1])
+                && word[n - 1] != 'l' && word[n - 1] != 's' && word[n - 1] != 'z') {
+            return word.left(n - 1);
+        }
+        return word;
+    }
+
+    const QSet<QString> &stopWords()
+    {
+        static const QSet<QString> words = QSet<QString>()
+                << "a" << "an" << "the" << "to" << "of" << "in" << "on" << "at" << "for" << "by"
+                << "with" << "from" << "and" << "or" << "be" << "is" << "are" << "oneself" << "something"
+                << "somebody" << "someone" << "sth" << "sb" << "smb" << "smth" << "one's" << "etc";
+        return words;
+    }
+}
+
+ReverseIndex::ReverseIndex(QObject *parent)
+    : QObject(parent)
+    , built(false)
+{
+    connect(&builder, &QFutureWatcher<Data>::finished, this, &ReverseIndex::onBuildFinished);
+}
+
+QString ReverseIndex::stem(const QString &token)
+{
+    // A light Porter-style stemmer: enough to conflate hesitate/hesitates/hesitated/hesitating
+    QString word = token;
+    if (word.size() <= 3) return word;
+
+    if (word.endsWith("sses")) {
+        word.chop(2);
+    } else if (word.endsWith("ies") && word.size() > 4) {
+        word.chop(3);
+        word += 'y';
+    } else if (word.endsWith("ing") && word.size() > 5) {
+        word = undouble(word.left(word.size() - 3));
+    } else if (word.endsWith("ed") && word.size() > 4) {
+        word = undouble(word.left(word.size() - 2));
+    } else if (word.endsWith("ly") && word.size() > 4) {
+        word.chop(2);
+    } else if (word.endsWith('s') && !word.endsWith("ss") && !word.endsWith("us") && word.size() > 3) {
+        word.chop(1);
+    }
+
+    if (word.endsWith('e') && word.size() > 3) {
+        word.chop(1);
+    }
+    return word;
+}
+
+QStringList ReverseIndex::terms(const QString &text, bool keepStopWords)
+{
+    static const QRegularExpression separator("[^a-z']+");
+
+    QStringList result;
+    for (const QString &token : text.toLower().split(separator)) {
+        QString word = token;
+        word.remove('\'');
+        if (word.isEmpty() || (!keepStopWords && stopWords().contains(token))) continue;
+
+        QString stemmed = stem(word);
+        if (!result.contains(stemmed)) {
+            result << stemmed;
+        }
+    }
+    return result;
+}
+
+void ReverseIndex::Data::add(const QString &word, const QJsonObject &wordData)
+{
+    // A word stored again replaces its entry in place: drop the old postings
+    // and reuse the slot, so re-added words don't accumulate dead entries.
+    // Keyed like EntryCache, so "Дом" and "дом" share one slot.
+    const QString key = EntryCache::normalizeWord(word);
+    int entryIndex = entryForWord.value(key, -1);
+    if (entryIndex >= 0) {
+        const QStringList &oldTranslations = entries[entryIndex].translations;
+        for (const QString &translation : oldTranslations) {
+            for (const QString &term : ReverseIndex::terms(translation, true)) {
+                QVector<Posting> &list = postings[term];
+                list.erase(std::remove_if(list.begin(), list.end(), [entryIndex](const Posting &posting) {
+                    return posting.entry == entryIndex;
+                }), list.end());
+                if (list.isEmpty()) {
+                    postings.remove(term);
+                }
+            }
+        }
+    } else {
+        entryIndex = entries.size();
+    }
+
+    Entry entry;
+    entry.word = key;
+
+    const QJsonArray translations = wordData["translations"].toArray();
+    for (const QJsonValue &transValue : translations) {
+        QStringList tls;
+        for (const QJsonValue &tl : transValue.toObject()["tls"].toArray()) {
+            tls << tl.toString();
+        }
+        if (tls.isEmpty()) continue;
+
+        int translationIndex = entry.translations.size();
+        entry.translations << tls.join(", ");
+
+        for (const QString &term : ReverseIndex::terms(tls.join(" "), true)) {
+            Posting posting;
+            posting.entry = entryIndex;
+            posting.translation = translationIndex;
+            postings[term].append(posting);
+        }
+    }
+
+    if (entryIndex < entries.size()) {
+        entries[entryIndex] = entry;
+    } else {
+        entries.append(entry);
+        entryForWord.insert(key, entryIndex);
+    }
+}
+
+void ReverseIndex::buildFromDirectory(const QString &directory)
+{
+    built = false;
+    builder.setFuture(QtConcurrent::run([directory]() {
+        Data result;
+        EntryCache::readDirectory(directory, [&result](const QString &word, const QJsonObject &wordData) {
+            result.add(word, wordData);
+        });
+        return result;
+    }));
+}
+
+void ReverseIndex::onBuildFinished()
+{
+    data = builder.result();
+
+    // Entries parsed while the worker was reading the directory
+    for (const QPair<QString, QJsonObject> &added : addedWhileBuilding) {
+        data.add(added.first, added.second);
+    }
+    addedWhileBuilding.clear();
+
+    built = true;
+    emit ready();
+}
+
+bool ReverseIndex::isReady() const
+{
+    return built;
+}
+
+int ReverseIndex::size() const
+{
+    return data.entryForWord.size();
+}
+
+void ReverseIndex::addEntry(const QString &word, const QJsonObject &wordData)
+{
+    // While the worker builds, data is about to be replaced by its result;
+    // the entry is applied on top of that in onBuildFinished
+    if (builder.isRunning()) {
+        addedWhileBuilding.append(qMakePair(word, wordData));
+    } else {
+        data.add(word, wordData);
+    }
+}
+
+QVector<ReverseIndex::Match> ReverseIndex::search(const QString &query, int limit) const
+{
+    QStringList queryTerms = terms(query);
+    if (queryTerms.isEmpty()) {
+        // Queries made only of stop words ("to be") still have to match something
+        queryTerms = terms(query, true);
+    }
+    if (queryTerms.isEmpty()) {
+        return QVector<Match>();
+    }
+
+    // Count matched query terms per (entry, translation)
+    QHash<qint64, int> matchedTerms;
+    for (const QString &term : queryTerms) {
+        QSet<qint64> seen;
+        for (const Posting &posting : data.postings.value(term)) {
+            qint64 key = (qint64(posting.entry) << 16) | posting.translation;
+            if (!seen.contains(key)) {
+                seen.insert(key);
+                matchedTerms[key]++;
+            }
+        }
+    }
+
+    QString normalizedQuery = query.toLower().simplified();
+    if (normalizedQuery.startsWith("to ")) normalizedQuery.remove(0, 3);
+
+    // Best translation of each entry
+    QHash<int, Match> best;
+    for (auto it = matchedTerms.constBegin(); it != matchedTerms.constEnd(); ++it) {
+        int entryIndex = int(it.key() >> 16);
+        int translationIndex = int(it.key() & 0xFFFF);
+        const Entry &entry = data.entries[entryIndex];
+        if (translationIndex >= entry.translations.size()) continue;
+
+        const QString &translation = entry.translations[translationIndex];
+        double score = 10.0 * it.value() / queryTerms.size() + 3.0 / (1 + translationIndex);
+
+        // Bonus when a translation is exactly the query ("to hesitate" for "hesitate")
+        for (QString tl : translation.split(", ")) {
+            tl = tl.toLower().simplified();
+            if (tl.startsWith("to ")) tl.remove(0, 3);
+            if (tl == normalizedQuery) {
+                score += 5.0;
+                break;
+            }
+        }
+
+        if (!best.contains(entryIndex) || best[entryIndex].score < score) {
+            Match match;
+            match.word = entry.word;
+            match.translation = translation;
+            match.score = score;
+            best.insert(entryIndex, match);
+        }
+    }
+
+    QVector<Match> matches;
+    matches.reserve(best.size());
+    for (const Match &match : best) {
+        matches.append(match);
+    }
+    std::sort(matches.begin(), matches.end(), [](const Match &a, const Match &b) {
+        return a.score != b.score ? a.score > b.score : a.word < b.word;
+    });
+    if (matches.size() > limit) {
+        matches.resize(limit);
+    }
+    return matches;
+}
@@ -0,0 +1,74 @@
+#ifndef REVERSEINDEX_H
+#define REVERSEINDEX_H
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QJsonObject>
+#include <QPair>
+#include <QStringList>
+#include <QVector>
+
+// English -> Russian index over the translations[].tls strings of cached entries.
+// English words are stemmed; matches are ranked by how many query terms a
+// translation contains and by the translation's position in the entry.
+class ReverseIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Match
+    {
+        QString word;
+        QString translation;
+        double score;
+    };
+
+    explicit ReverseIndex(QObject *parent = nullptr);
+
+    // Index every entry of an entry cache directory in a worker thread
+    void buildFromDirectory(const QString &directory);
+    bool isReady() const;
+    int size() const;
+
+    void addEntry(const QString &word, const QJsonObject &wordData);
+    QVector<Match> search(const QString &query, int limit = 30) const;
+
+    static QString stem(const QString &token);
+    static QStringList terms(const QString &text, bool keepStopWords = false);
+
+signals:
+    void ready();
+
+private slots:
+    void onBuildFinished();
+
+private:
+    struct Posting
+    {
+        int entry;
+        int translation;
+    };
+
+    struct Entry
+    {
+        QString word;
+        QStringList translations;
+    };
+
+    struct Data
+    {
+        QVector<Entry> entries;
+        QHash<QString, int> entryForWord;  // by EntryCache::normalizeWord
+        QHash<QString, QVector<Posting>> postings;
+
+        void add(const QString &word, const QJsonObject &wordData);
+    };
+
+    Data data;
+    bool built;
+    QFutureWatcher<Data> builder;
+    QList<QPair<QString, QJsonObject>> addedWhileBuilding;
+};
+
+#endif // REVERSEINDEX_H
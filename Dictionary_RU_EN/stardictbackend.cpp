@@ -0,0 +1,286 @@
+#include "stardictbackend.h"
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QRegularExpression>
+#include <QtEndian>
+#include <cstring>
+
+namespace
+{
+    // StarDict sorts keys with g_ascii_strcasecmp(), ties broken by strcmp()
+    int asciiCaseCompare(const char *a, const char *b)
+    {
+        for (;; ++a, ++b) {
+            int ca = uchar(*a);
+            int cb = uchar(*b);
+            if (ca >= 'A' && ca <= 'Z') ca += 'a' - 'A';
+            if (cb >= 'A' && cb <= 'Z') cb += 'a' - 'A';
+            if (ca != cb || ca == 0) {
+                return ca - cb;
+            }
+        }
+    }
+
+    int stardictCompare(const char *a, const char *b)
+    {
+        int result = asciiCaseCompare(a, b);
+        return result != 0 ? result : qstrcmp(a, b);
+    }
+
+    // Convert a textual article field into plain lines
+    QStringList articleLines(char type, const QByteArray &field)
+    {
+        QString text = QString::fromUtf8(field);
+        if (type == 'h' || type == 'x' || type == 'g') {
+            text.replace(QRegularExpression("<br\\s*/?>|</p>|</div>|</def>", QRegularExpression::CaseInsensitiveOption), "\n");
+            text.remove(QRegularExpression("<[^>]*>"));
+            text.replace("&lt;", "<").replace("&gt;", ">").replace("&quot;", "\"").replace("&amp;", "&");
+        }
+
+        QStringList lines;
+        for (const QString &line : text.split('\n')) {
+            QString simplified = line.simplified();
+            if (!simplified.isEmpty()) {
+                lines << simplified;
+            }
+        }
+        return lines;
+    }
+
+    // Upper-case field types carry a 32-bit size instead of a terminating null
+    bool isSizedType(char type)
+    {
+        return type >= 'A' && type <= 'Z';
+    }
+
+    bool isTextType(char type)
+    {
+        return type == 'm' || type == 'l' || type == 'g' || type == 't'
+                || type == 'x' || type == 'y' || type == 'k' || type == 'h';
+    }
+}
+
+StarDictBackend::StarDictBackend(QObject *parent)
+    : LocalDictionaryBackend(parent)
+    , wordCount(0)
+    , offsetBits(32)
+    , indexData(nullptr)
+    , indexSize(0)
+{
+}
+
+StarDictBackend::~StarDictBackend()
+{
+    if (indexData) {
+        indexFile.unmap(const_cast<uchar *>(indexData));
+    }
+}
+
+QString StarDictBackend::name() const
+{
+    return bookName;
+}
+
+bool StarDictBackend::open(const QString &ifoPath)
+{
+    if (!readInfo(ifoPath)) {
+        return false;
+    }
+
+    QFileInfo info(ifoPath);
+    QString basePath = info.path() + "/" + info.completeBaseName();
+
+    // Compressed .idx.gz cannot be mapped, only plain .idx is supported
+    indexFile.setFileName(basePath + ".idx");
+    if (!indexFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    indexSize = indexFile.size();
+    indexData = indexFile.map(0, indexSize);
+    if (!indexData || !indexRecords()) {
+        return false;
+    }
+
+    return dictFile.open(basePath + ".dict.dz") || dictFile.open(basePath + ".dict");
+}
+
+bool StarDictBackend::readInfo(const QString &ifoPath)
+{
+    QFile file(ifoPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QStringList lines = QString::fromUtf8(file.readAll()).split('\n');
+    if (lines.isEmpty() || !lines.first().startsWith("StarDict's dict ifo file")) {
+        return false;
+    }
+
+    bookName = QFileInfo(ifoPath).completeBaseName();
+    for (const QString &line : lines) {
+        int equals = line.indexOf('=');
+        if (equals <= 0) continue;
+
+        QString key = line.left(equals).trimmed();
+        QString value = line.mid(equals + 1).trimmed();
+        if (key == "bookname") {
+            bookName = value;
+        } else if (key == "wordcount") {
+            wordCount = value.toInt();
+        } else if (key == "idxoffsetbits") {
+            offsetBits = value.toInt();
+        } else if (key == "sametypesequence") {
+            sameTypeSequence = value.toLatin1();
+        }
+    }
+
+    return wordCount > 0 && (offsetBits == 32 || offsetBits == 64);
+}
+
+bool StarDictBackend::indexRecords()
+{
+    // Record: null-terminated key, then big-endian data offset and size
+    const int tailSize = (offsetBits == 64 ? 8 : 4) + 4;
+    recordOffsets.reserve(wordCount);
+
+    qint64 pos = 0;
+    while (pos < indexSize) {
+        const void *end = memchr(indexData + pos, 0, size_t(indexSize - pos));
+        if (!end) {
+            return false;
+        }
+        qint64 next = (static_cast<const uchar *>(end) - indexData) + 1 + tailSize;
+        if (next > indexSize) {
+            return false;
+        }
+        recordOffsets << quint32(pos);
+        pos = next;
+    }
+
+    return !recordOffsets.isEmpty();
+}
+
+const char *StarDictBackend::keyAt(int index) const
+{
+    return reinterpret_cast<const char *>(indexData + recordOffsets[index]);
+}
+
+void StarDictBackend::recordAt(int index, quint64 *offset, quint32 *size) const
+{
+    const char *key = keyAt(index);
+    const uchar *tail = reinterpret_cast<const uchar *>(key) + qstrlen(key) + 1;
+    if (offsetBits == 64) {
+        *offset = qFromBigEndian<quint64>(tail);
+        *size = qFromBigEndian<quint32>(tail + 8);
+    } else {
+        *offset = qFromBigEndian<quint32>(tail);
+        *size = qFromBigEndian<quint32>(tail + 4);
+    }
+}
+
+int StarDictBackend::lowerBound(const QByteArray &key) const
+{
+    int low = 0;
+    int high = recordOffsets.size();
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (stardictCompare(keyAt(middle), key.constData()) < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+bool StarDictBackend::find(const QString &word, QJsonObject *wordData)
+{
+    if (!indexData) {
+        return false;
+    }
+
+    // Cyrillic case is not folded by the StarDict ordering, so try the lowercase form too
+    QStringList candidates;
+    candidates << word;
+    if (word.toLower() != word) {
+        candidates << word.toLower();
+    }
+
+    bool found = false;
+    for (const QString &candidate : candidates) {
+        QByteArray key = candidate.toUtf8();
+        for (int i = lowerBound(key); i < recordOffsets.size() && qstrcmp(keyAt(i), key.constData()) == 0; ++i) {
+            quint64 offset;
+            quint32 size;
+            recordAt(i, &offset, &size);
+            appendArticle(dictFile.read(offset, size), wordData);
+            found = true;
+        }
+        if (found) break;
+    }
+
+    return found && !(*wordData)["translations"].toArray().isEmpty();
+}
+
+void StarDictBackend::appendArticle(const QByteArray &article, QJsonObject *wordData) const
+{
+    QStringList lines;
+    int pos = 0;
+
+    if (!sameTypeSequence.isEmpty()) {
+        // Field types are given once in the .ifo; the last field runs to the end of the article
+        for (int t = 0; t < sameTypeSequence.size() && pos < article.size(); ++t) {
+            char type = sameTypeSequence[t];
+            bool last = t == sameTypeSequence.size() - 1;
+            int end;
+            if (isSizedType(type)) {
+                if (last) {
+                    end = article.size();
+                } else {
+                    if (article.size() - pos < 4) break;
+                    quint32 size = qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(article.constData() + pos));
+                    pos += 4;
+                    // A corrupt length must not take pos outside the article
+                    if (size > quint32(article.size() - pos)) break;
+                    end = pos + int(size);
+                }
+            } else {
+                end = last ? article.size() : article.indexOf('\0', pos);
+                if (end < 0) end = article.size();
+            }
+            if (isTextType(type)) {
+                lines << articleLines(type, article.mid(pos, end - pos));
+            }
+            pos = end + (isSizedType(type) || last ? 0 : 1);
+        }
+    } else {
+        // Each field starts with its type character
+        while (pos < article.size()) {
+            char type = article[pos++];
+            int end;
+            if (isSizedType(type)) {
+                if (article.size() - pos < 4) break;
+                quint32 size = qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(article.constData() + pos));
+                pos += 4;
+                if (size > quint32(article.size() - pos)) break;
+                end = pos + int(size);
+            } else {
+                end = article.indexOf('\0', pos);
+                if (end < 0) end = article.size();
+            }
+            if (isTextType(type)) {
+                lines << articleLines(type, article.mid(pos, end - pos));
+            }
+            pos = end + (isSizedType(type) ? 0 : 1);
+        }
+    }
+
+    QJsonArray translations = (*wordData)["translations"].toArray();
+    for (const QString &line : lines) {
+        QJsonObject translation;
+        translation["tls"] = QJsonArray() << line;
+        translation["source"] = bookName;
+        translations.append(translation);
+    }
+    (*wordData)["translations"] = translations;
+}
@@ -0,0 +1,46 @@
+#ifndef STARDICTBACKEND_H
+#define STARDICTBACKEND_H
+
+#include "dictionarybackend.h"
+#include "dictzipfile.h"
+#include <QFile>
+#include <QVector>
+
+// Offline StarDict dictionary (.ifo/.idx/.dict[.dz]).
+// The .idx file is memory-mapped and searched in place; only the start
+// offset of each index record is kept in memory.
+class StarDictBackend : public LocalDictionaryBackend
+{
+    Q_OBJECT
+
+public:
+    explicit StarDictBackend(QObject *parent = nullptr);
+    ~StarDictBackend();
+
+    bool open(const QString &ifoPath);
+
+    QString name() const override;
+    bool find(const QString &word, QJsonObject *wordData) override;
+
+private:
+    bool readInfo(const QString &ifoPath);
+    bool indexRecords();
+    int lowerBound(const QByteArray &key) const;
+    const char *keyAt(int index) const;
+    void recordAt(int index, quint64 *offset, quint32 *size) const;
+    void appendArticle(const QByteArray &article, QJsonObject *wordData) const;
+
+    QString bookName;
+    int wordCount;
+    int offsetBits;
+    QByteArray sameTypeSequence;
+
+    QFile indexFile;
+    const uchar *indexData;
+    qint64 indexSize;
+    QVector<quint32> recordOffsets;
+
+    DictZipFile dictFile;
+};
+
+#endif // STARDICTBACKEND_H
@@ -0,0 +1,505 @@
+#include "syncbundle.h"
+#include "entrycache.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QSet>
+#include <QSysInfo>
+#include <algorithm>
+
+namespace
+{
+    const int MinChunkSize = 2 * 1024;
+    const int MaxChunkSize = 64 * 1024;
+    const int AverageChunkBits = 13;    // 8 KiB
+
+    // Random but fixed per-byte values of the gear hash; every machine must cut at the same places
+    const quint64 *gearTable()
+    {
+        static quint64 table[256];
+        static bool initialized = [] {
+            quint64 state = 0x5DEECE66DULL;
+            for (quint64 &value : table) {
+                // splitmix64
+                state += 0x9E3779B97F4A7C15ULL;
+                quint64 z = state;
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                value = z ^ (z >> 31);
+            }
+            return true;
+        }();
+        Q_UNUSED(initialized);
+        return table;
+    }
+
+    QString hashOf(const QByteArray &data)
+    {
+        return QString::fromLatin1(QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex());
+    }
+
+    bool writeFile(const QString &filePath, const QByteArray &data)
+    {
+        QDir().mkpath(QFileInfo(filePath).absolutePath());
+        QSaveFile file(filePath);
+        return file.open(QIODevice::WriteOnly) && file.write(data) == data.size() && file.commit();
+    }
+
+    // "yyyy-MM-dd hh:mm:ss|word|" identifies a history record
+    QByteArray historyKey(const QByteArray &line)
+    {
+        int first = line.indexOf('|');
+        int second = first < 0 ? -1 : line.indexOf('|', first + 1);
+        return second < 0 ? QByteArray() : line.left(second);
+    }
+}
+
+SyncBundle::SyncBundle(const QString &syncDirectory, const QString &historyFile,
+                       const QString &entryCacheDirectory, const QString &audioDirectory)
+    : syncDirectory(syncDirectory)
+    , historyFile(historyFile)
+    , entryCacheDirectory(entryCacheDirectory)
+    , audioDirectory(audioDirectory)
+{
+}
+
+SyncBundle::Stats SyncBundle::stats() const
+{
+    return counters;
+}
+
+QString SyncBundle::errorString() const
+{
+    return error;
+}
+
+void SyncBundle::setProgressHandler(const std::function<void(const QString &, int, int)> &handler)
+{
+    progressHandler = handler;
+}
+
+void SyncBundle::reportProgress(const QString &stage, int done, int total) const
+{
+    if (progressHandler) {
+        progressHandler(stage, done, total);
+    }
+}
+
+QStringList SyncBundle::importedEntryFiles() const
+{
+    return importedEntries;
+}
+
+QVector<int> SyncBundle::chunkLengths(const QByteArray &data)
+{
+    const quint64 *gear = gearTable();
+    const uchar *bytes = reinterpret_cast<const uchar *>(data.constData());
+    const int size = data.size();
+
+    QVector<int> lengths;
+    int start = 0;
+    while (start < size) {
+        int end = qMin(start + MaxChunkSize, size);
+        int pos = qMin(start + MinChunkSize, end);
+
+        // Cut where the top bits of the hash over the last 64 bytes are all zero
+        quint64 hash = 0;
+        for (; pos < end; ++pos) {
+            hash = (hash << 1) + gear[bytes[pos]];
+            if ((hash >> (64 - AverageChunkBits)) == 0) {
+                ++pos;
+                break;
+            }
+        }
+
+        lengths << pos - start;
+        start = pos;
+    }
+    return lengths;
+}
+
+QString SyncBundle::chunkPath(const QString &hash) const
+{
+    return QString("%1/chunks/%2/%3").arg(syncDirectory, hash.left(2), hash);
+}
+
+QJsonArray SyncBundle::storeData(const QByteArray &data)
+{
+    QJsonArray chunks;
+    int offset = 0;
+    for (int length : chunkLengths(data)) {
+        QByteArray chunk = data.mid(offset, length);
+        offset += length;
+
+        QString hash = hashOf(chunk);
+        chunks.append(hash);
+
+        // Chunks are immutable, an existing one is already the right content.
+        // Touch it so that pruning on another machine sees it as in use.
+        QString path = chunkPath(hash);
+        if (QFile::exists(path)) {
+            QFile existing(path);
+            if (existing.open(QIODevice::ReadWrite)) {
+                existing.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+            }
+            continue;
+        }
+
+        QByteArray compressed = qCompress(chunk);
+        if (writeFile(path, compressed)) {
+            counters.chunksWritten++;
+            counters.bytesWritten += compressed.size();
+        }
+    }
+    return chunks;
+}
+
+bool SyncBundle::loadData(const QJsonArray &chunks, QByteArray *data)
+{
+    data->clear();
+    for (const QJsonValue &value : chunks) {
+        QString hash = value.toString();
+        QFile file(chunkPath(hash));
+        if (!file.open(QIODevice::ReadOnly)) {
+            error = "Missing chunk " + hash;
+            return false;
+        }
+
+        QByteArray compressed = file.readAll();
+        counters.bytesRead += compressed.size();
+
+        QByteArray chunk = qUncompress(compressed);
+        if (hashOf(chunk) != hash) {
+            error = "Corrupt chunk " + hash;
+            return false;
+        }
+        data->append(chunk);
+    }
+    return true;
+}
+
+QString SyncBundle::machineId() const
+{
+    QString id = QString::fromLatin1(QSysInfo::machineUniqueId());
+    if (id.isEmpty()) id = QSysInfo::machineHostName();
+    return EntryCache::safeFileName(id);
+}
+
+QList<SyncBundle::LocalFile> SyncBundle::localFiles() const
+{
+    QList<LocalFile> files;
+    if (QFile::exists(historyFile)) {
+        files.append({"history", historyFile});
+    }
+
+    QDirIterator entries(entryCacheDirectory, QStringList() << "*.json", QDir::Files);
+    while (entries.hasNext()) {
+        QString path = entries.next();
+        files.append({"entries/" + entries.fileName(), path});
+    }
+
+    QDirIterator audio(audioDirectory, QStringList() << "*.mp3", QDir::Files);
+    while (audio.hasNext()) {
+        QString path = audio.next();
+        files.append({"audio/" + audio.fileName(), path});
+    }
+    return files;
+}
+
+QString SyncBundle::localPath(const QString &key) const
+{
+    if (key == "history") return historyFile;
+    if (key.startsWith("entries/")) return entryCacheDirectory + "/" + QFileInfo(key).fileName();
+    if (key.startsWith("audio/")) return audioDirectory + "/" + QFileInfo(key).fileName();
+    return QString();
+}
+
+bool SyncBundle::readManifest(const QString &manifestPath, QString *rootHash, QHash<QString, QJsonObject> *files)
+{
+    QFile file(manifestPath);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QByteArray root = file.readAll();
+    *rootHash = hashOf(root);
+    if (!files) return true;
+
+    QByteArray listing;
+    if (!loadData(QJsonDocument::fromJson(root).object()["chunks"].toArray(), &listing)) return false;
+
+    // One JSON object per line, sorted by key
+    for (const QByteArray &line : listing.split('\n')) {
+        QJsonObject entry = QJsonDocument::fromJson(line).object();
+        if (!entry.isEmpty()) {
+            files->insert(entry["key"].toString(), entry);
+        }
+    }
+    return true;
+}
+
+bool SyncBundle::exportBundle()
+{
+    error.clear();
+    QString manifestPath = QString("%1/manifests/%2.json").arg(syncDirectory, machineId());
+
+    // Files unchanged since the last export keep their chunk list without being read
+    QString previousRoot;
+    QHash<QString, QJsonObject> previous;
+    readManifest(manifestPath, &previousRoot, &previous);
+
+    QList<LocalFile> files = localFiles();
+    std::sort(files.begin(), files.end(), [](const LocalFile &a, const LocalFile &b) { return a.key < b.key; });
+
+    QByteArray listing;
+    for (const LocalFile &localFile : files) {
+        QFileInfo info(localFile.filePath);
+        counters.filesScanned++;
+        reportProgress("Sending", counters.filesScanned, files.size());
+
+        QJsonObject entry = previous.value(localFile.key);
+        if (entry.isEmpty() || entry["size"].toDouble() != info.size()
+            || entry["modified"].toDouble() != info.lastModified().toMSecsSinceEpoch()) {
+            QFile file(localFile.filePath);
+            if (!file.open(QIODevice::ReadOnly)) continue;
+            QByteArray data = file.readAll();
+
+            entry = QJsonObject();
+            entry["key"] = localFile.key;
+            entry["size"] = double(info.size());
+            entry["modified"] = double(info.lastModified().toMSecsSinceEpoch());
+            entry["hash"] = hashOf(data);
+            entry["chunks"] = storeData(data);
+            counters.filesChanged++;
+        }
+
+        listing += QJsonDocument(entry).toJson(QJsonDocument::Compact);
+        listing += '\n';
+    }
+
+    QJsonObject root;
+    root["machine"] = QSysInfo::machineHostName();
+    root["created"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    root["files"] = files.size();
+    root["chunks"] = storeData(listing);
+
+    QByteArray rootData = QJsonDocument(root).toJson(QJsonDocument::Compact);
+    if (!writeFile(manifestPath, rootData)) {
+        error = "Cannot write " + manifestPath;
+        return false;
+    }
+    counters.bytesWritten += rootData.size();
+
+    // Our own manifest never needs importing
+    QJsonObject state = loadState();
+    QJsonObject imported = state["imported"].toObject();
+    imported[machineId()] = hashOf(rootData);
+    state["imported"] = imported;
+    saveState(state);
+
+    pruneChunks();
+    return true;
+}
+
+void SyncBundle::pruneChunks()
+{
+    // Best effort: a manifest that cannot be read leaves everything in place
+    QString previousError = error;
+    QSet<QString> referenced;
+    bool complete = true;
+
+    QDirIterator manifests(syncDirectory + "/manifests", QStringList() << "*.json", QDir::Files);
+    while (complete && manifests.hasNext()) {
+        QString manifestPath = manifests.next();
+
+        // The chunks holding the listing itself, then the chunks of every file
+        QFile file(manifestPath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            complete = false;
+            break;
+        }
+        for (const QJsonValue &hash : QJsonDocument::fromJson(file.readAll()).object()["chunks"].toArray()) {
+            referenced.insert(hash.toString());
+        }
+
+        QString rootHash;
+        QHash<QString, QJsonObject> files;
+        complete = readManifest(manifestPath, &rootHash, &files);
+        for (const QJsonObject &entry : files) {
+            for (const QJsonValue &hash : entry["chunks"].toArray()) {
+                referenced.insert(hash.toString());
+            }
+        }
+    }
+    error = previousError;
+    if (!complete) return;
+
+    // Another machine may be exporting right now and writes its chunks before
+    // its manifest, so only chunks untouched for a day are removed
+    const QDateTime cutoff = QDateTime::currentDateTime().addDays(-1);
+    QDirIterator chunks(syncDirectory + "/chunks", QDir::Files, QDirIterator::Subdirectories);
+    while (chunks.hasNext()) {
+        QString path = chunks.next();
+        if (referenced.contains(chunks.fileName()) || chunks.fileInfo().lastModified() > cutoff) continue;
+        if (QFile::remove(path)) {
+            counters.chunksRemoved++;
+        }
+    }
+}
+
+QString SyncBundle::localHash(const QString &key, const QString &filePath, const QHash<QString, QJsonObject> &exported) const
+{
+    // Our last manifest already has the hash of every file that has not changed since
+    QFileInfo info(filePath);
+    QJsonObject entry = exported.value(key);
+    if (!entry.isEmpty() && entry["size"].toDouble() == info.size()
+        && entry["modified"].toDouble() == info.lastModified().toMSecsSinceEpoch()) {
+        return entry["hash"].toString();
+    }
+
+    QFile file(filePath);
+    return file.open(QIODevice::ReadOnly) ? hashOf(file.readAll()) : QString();
+}
+
+bool SyncBundle::importBundles()
+{
+    // Hashes of the local files as of our last export
+    QString exportedRoot;
+    QHash<QString, QJsonObject> exported;
+    readManifest(QString("%1/manifests/%2.json").arg(syncDirectory, machineId()), &exportedRoot, &exported);
+
+    error.clear();
+    importedEntries.clear();
+
+    QJsonObject state = loadState();
+    QJsonObject imported = state["imported"].toObject();
+    bool ok = true;
+
+    QDirIterator manifests(syncDirectory + "/manifests", QStringList() << "*.json", QDir::Files);
+    while (manifests.hasNext()) {
+        QString manifestPath = manifests.next();
+        QString machine = QFileInfo(manifestPath).completeBaseName();
+        if (machine == machineId()) continue;
+
+        // Skip machines that have not exported anything new
+        QString rootHash;
+        if (!readManifest(manifestPath, &rootHash, nullptr) || imported[machine].toString() == rootHash) continue;
+
+        QHash<QString, QJsonObject> files;
+        if (!readManifest(manifestPath, &rootHash, &files)) {
+            ok = false;
+            continue;
+        }
+
+        bool complete = true;
+        int done = 0;
+        for (const QJsonObject &entry : files) {
+            reportProgress("Receiving", ++done, files.size());
+            QString key = entry["key"].toString();
+            QString path = localPath(key);
+            if (path.isEmpty()) continue;
+
+            // An entry or pronunciation both machines have: nothing to do when the
+            // content is the same, otherwise the more recently modified one wins
+            bool isHistory = key == "history";
+            if (!isHistory && QFile::exists(path)) {
+                if (localHash(key, path, exported) == entry["hash"].toString()) continue;
+                if (QFileInfo(path).lastModified().toMSecsSinceEpoch() >= qint64(entry["modified"].toDouble())) continue;
+            }
+
+            QByteArray data;
+            if (!loadData(entry["chunks"].toArray(), &data)) {
+                complete = false;
+                continue;
+            }
+
+            if (isHistory) {
+                complete = mergeHistory(data) && complete;
+            } else if (writeFile(path, data)) {
+                counters.filesImported++;
+                if (key.startsWith("entries/")) {
+                    importedEntries << path;
+                }
+            }
+        }
+
+        if (complete) {
+            imported[machine] = rootHash;
+        } else {
+            ok = false;
+        }
+    }
+
+    state["imported"] = imported;
+    saveState(state);
+    return ok;
+}
+
+bool SyncBundle::mergeHistory(const QByteArray &remote)
+{
+    QByteArray local;
+    QFile file(historyFile);
+    if (file.open(QIODevice::ReadOnly)) {
+        local = file.readAll();
+        file.close();
+    }
+    if (local == remote) return true;
+
+    // Lines are compared as bytes, so the history keeps whatever encoding it was written in
+    QList<QByteArray> lines;
+    QSet<QByteArray> keys;
+    for (const QByteArray &line : local.split('\n')) {
+        QByteArray trimmed = line.endsWith('\r') ? line.left(line.size() - 1) : line;
+        if (trimmed.isEmpty()) continue;
+        keys.insert(historyKey(trimmed));
+        lines.append(trimmed);
+    }
+
+    int added = 0;
+    for (const QByteArray &line : remote.split('\n')) {
+        QByteArray trimmed = line.endsWith('\r') ? line.left(line.size() - 1) : line;
+        QByteArray key = historyKey(trimmed);
+        if (key.isEmpty() || keys.contains(key)) continue;
+        keys.insert(key);
+        lines.append(trimmed);
+        added++;
+    }
+    if (added == 0) return true;
+
+    // Timestamps lead every line and sort chronologically as text
+    std::stable_sort(lines.begin(), lines.end(), [](const QByteArray &a, const QByteArray &b) {
+        return a.left(19) < b.left(19);
+    });
+
+    QByteArray merged;
+    for (const QByteArray &line : lines) {
+        merged += line;
+#ifdef Q_OS_WIN
+        merged += "\r\n";
+#else
+        merged += '\n';
+#endif
+    }
+    if (!writeFile(historyFile, merged)) {
+        error = "Cannot write " + historyFile;
+        return false;
+    }
+
+    counters.historyRecordsAdded += added;
+    return true;
+}
+
+QJsonObject SyncBundle::loadState() const
+{
+    QFile file(QFileInfo(historyFile).absolutePath() + "/sync_state.json");
+    if (!file.open(QIODevice::ReadOnly)) return QJsonObject();
+    return QJsonDocument::fromJson(file.readAll()).object();
+}
+
+void SyncBundle::saveState(const QJsonObject &state) const
+{
+    writeFile(QFileInfo(historyFile).absolutePath() + "/sync_state.json", QJsonDocument(state).toJson());
+}
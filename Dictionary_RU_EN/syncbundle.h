@@ -0,0 +1,95 @@
+#ifndef SYNCBUNDLE_H
+#define SYNCBUNDLE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <functional>
+
+// Synchronizes the history, entry cache and pronunciations of several machines
+// through a shared directory (network share, USB drive...).
+//
+// Every file is cut into content-defined chunks (a gear rolling hash picks the
+// boundaries, so an edit or an append only changes the chunks around it). Chunks
+// are stored once under chunks/, named by their SHA-1. Each machine writes a
+// manifest listing its files and their chunks; the manifest is chunked the same
+// way, so manifests/<machine>.json only points at a few chunk hashes.
+//
+// Importing merges the history records by timestamp and word. Entries and
+// pronunciations are compared by hash; when both machines have a different
+// version of a file, the more recently modified one wins (last writer wins).
+// Exporting removes the chunks no manifest refers to any more.
+class SyncBundle
+{
+public:
+    struct Stats
+    {
+        int filesScanned = 0;
+        int filesChanged = 0;
+        int chunksWritten = 0;
+        int chunksRemoved = 0;
+        qint64 bytesWritten = 0;
+        int filesImported = 0;
+        int historyRecordsAdded = 0;
+        qint64 bytesRead = 0;
+    };
+
+    SyncBundle(const QString &syncDirectory, const QString &historyFile,
+               const QString &entryCacheDirectory, const QString &audioDirectory);
+
+    // Write the new chunks and the manifest of this machine
+    bool exportBundle();
+    // Merge what the other machines have exported since the last import
+    bool importBundles();
+
+    Stats stats() const;
+    QString errorString() const;
+
+    // Called on the thread running the import or export as files are processed
+    void setProgressHandler(const std::function<void(const QString &stage, int done, int total)> &handler);
+    // Entry cache files written by importBundles()
+    QStringList importedEntryFiles() const;
+
+    // Content-defined chunk lengths of data (2-64 KiB, about 10 KiB on average)
+    static QVector<int> chunkLengths(const QByteArray &data);
+
+private:
+    struct LocalFile
+    {
+        QString key;       // "history", "entries/<file>" or "audio/<file>"
+        QString filePath;
+    };
+
+    QList<LocalFile> localFiles() const;
+    QString localPath(const QString &key) const;
+    QString machineId() const;
+
+    QJsonArray storeData(const QByteArray &data);
+    bool loadData(const QJsonArray &chunks, QByteArray *data);
+    QString chunkPath(const QString &hash) const;
+
+    bool readManifest(const QString &manifestPath, QString *rootHash, QHash<QString, QJsonObject> *files);
+    bool mergeHistory(const QByteArray &remote);
+    QString localHash(const QString &key, const QString &filePath, const QHash<QString, QJsonObject> &exported) const;
+    void pruneChunks();
+    void reportProgress(const QString &stage, int done, int total) const;
+
+    QJsonObject loadState() const;
+    void saveState(const QJsonObject &state) const;
+
+    QString syncDirectory;
+    QString historyFile;
+    QString entryCacheDirectory;
+    QString audioDirectory;
+
+    Stats counters;
+    QString error;
+    QStringList importedEntries;
+    std::function<void(const QString &stage, int done, int total)> progressHandler;
+};
+
+#endif // SYNCBUNDLE_H
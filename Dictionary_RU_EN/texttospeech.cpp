@@ -0,0 +1,41 @@
+#include "texttospeech.h"
+#include <QRegularExpression>
+
+namespace TextToSpeech
+{
+
+namespace
+{
+    QString serviceUrl = "https://translate.google.com";
+}
+
+QString baseUrl()
+{
+    return serviceUrl;
+}
+
+void setBaseUrl(const QString &url)
+{
+    serviceUrl = url;
+    while (serviceUrl.endsWith('/')) {
+        serviceUrl.chop(1);
+    }
+}
+
+QUrl speechUrl(const QString &text, const QString &language)
+{
+    // Encode text for URL
+    QString encodedText = QUrl::toPercentEncoding(text);
+    QString tl = language == "ru" ? "ru" : "en";
+
+    return QUrl(QString("%1/translate_tts?ie=UTF-8&tl=%2&client=tw-ob&q=%3").arg(serviceUrl, tl, encodedText));
+}
+
+QString localFilePath(const QString &text, const QString &language)
+{
+    QString safeWord = text;
+    safeWord.replace(QRegularExpression("[^a-zA-Z0-9а-яА-ЯёЁ]"), "_");
+    return QString("word_audio/%1_%2.mp3").arg(safeWord, language);
+}
+
+} // namespace TextToSpeech
@@ -0,0 +1,21 @@
+#ifndef TEXTTOSPEECH_H
+#define TEXTTOSPEECH_H
+
+#include <QString>
+#include <QUrl>
+
+// Google Translate text-to-speech endpoint used for pronunciations
+namespace TextToSpeech
+{
+    // Service root, "https://translate.google.com" unless overridden (e.g. by a local mock server)
+    QString baseUrl();
+    void setBaseUrl(const QString &url);
+
+    // MP3 URL speaking text in language ("ru" or "en")
+    QUrl speechUrl(const QString &text, const QString &language);
+
+    // Where the pronunciation of text is stored in the word_audio folder
+    QString localFilePath(const QString &text, const QString &language);
+}
+
+#endif // TEXTTOSPEECH_H
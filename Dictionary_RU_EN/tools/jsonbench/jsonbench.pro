@@ -0,0 +1,29 @@
+# Parse time and allocations of OpenRussian::extractWordData against the
+# previous QJsonDocument-based extraction, on hand-written fixture and synthesized pages:
+#   jsonbench --sentences 10,100,1000,5000
+QT      += core
+QT      -= gui
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+CONFIG -= debug_and_release
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+    main.cpp \
+    $$PWD/../../lazyjson.cpp \
+    $$PWD/../../openrussian.cpp
+
+HEADERS += \
+    $$PWD/../../lazyjson.h \
+    $$PWD/../../openrussian.h
+
+DESTDIR = ./
+
+# The load test's fixture pages
+fixtures.path = $$OUT_PWD/fixtures
+fixtures.files = $$PWD/../loadtest/fixtures/pages
+COPIES += fixtures
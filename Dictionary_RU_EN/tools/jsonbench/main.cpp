@@ -0,0 +1,271 @@
+#include "openrussian.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Allocation counting. On glibc every malloc is counted (Qt containers allocate
+// with malloc, not operator new); elsewhere only operator new is.
+static std::atomic<qint64> allocationCount(0);
+
+#ifdef __GLIBC__
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+
+void *malloc(size_t size)
+{
+    allocationCount++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    allocationCount++;
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size)
+{
+    allocationCount++;
+    return __libc_realloc(pointer, size);
+}
+}
+#else
+void *operator new(size_t size)
+{
+    allocationCount++;
+    if (void *pointer = std::malloc(size ? size : 1)) return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+#endif
+
+namespace
+{
+    struct Page
+    {
+        QString name;
+        QByteArray html;
+    };
+
+    // The extraction this benchmark compares against: the whole payload as a QJsonDocument
+    bool extractWithDocument(const QByteArray &html, QJsonObject *wordData)
+    {
+        QRegularExpression jsonRegex("<script id=\"__NEXT_DATA__\" type=\"application/json\">(.*?)</script>");
+        QRegularExpressionMatch jsonMatch = jsonRegex.match(QString::fromUtf8(html));
+        if (!jsonMatch.hasMatch()) {
+            return false;
+        }
+
+        QJsonDocument doc = QJsonDocument::fromJson(jsonMatch.captured(1).toUtf8());
+        if (doc.isNull()) {
+            return false;
+        }
+
+        QJsonObject root = doc.object();
+        QJsonObject props = root["props"].toObject();
+        QJsonObject pageProps = props["pageProps"].toObject();
+        QJsonObject info = pageProps["info"].toObject();
+
+        QJsonArray words = info["words"].toArray();
+        if (words.isEmpty()) {
+            return false;
+        }
+
+        *wordData = words[0].toObject();
+        return true;
+    }
+
+    // The fields extractWordData keeps, to check both extractions agree
+    QJsonObject usedFields(const QJsonObject &word)
+    {
+        QJsonObject result;
+        for (const char *key : {"ru", "accented"}) {
+            if (word.contains(key)) result[key] = word[key];
+        }
+
+        QJsonArray translations;
+        for (const QJsonValue &value : word["translations"].toArray()) {
+            QJsonObject translation = value.toObject();
+            QJsonObject kept;
+            kept["tls"] = translation["tls"].toArray();
+            for (const char *key : {"info", "exampleRu", "exampleTl"}) {
+                kept[key] = translation[key].toString();
+            }
+            translations.append(kept);
+        }
+        result["translations"] = translations;
+
+        QJsonArray sentences;
+        for (const QJsonValue &value : word["sentences"].toArray()) {
+            QJsonObject sentence = value.toObject();
+            QJsonObject kept;
+            kept["ru"] = sentence["ru"].toString();
+            kept["tl"] = sentence["tl"].toString();
+            sentences.append(kept);
+        }
+        result["sentences"] = sentences;
+        return result;
+    }
+
+    // A page shaped like a real one, with many sentences and the usual page state around the entry
+    QByteArray synthesizePage(int sentenceCount)
+    {
+        const QStringList words = {"дом", "говорить", "быть", "время", "рука", "дело", "жизнь", "день"};
+
+        QJsonObject word;
+        word["ru"] = "говорить";
+        word["accented"] = QString::fromUtf8("говори́ть");
+        word["type"] = "verb";
+        word["level"] = "A1";
+
+        QJsonArray translations;
+        for (int i = 0; i < 3 + sentenceCount / 50; ++i) {
+            QJsonObject translation;
+            translation["tls"] = QJsonArray{QString("to speak %1").arg(i), "to talk", "to say"};
+            translation["info"] = "imperfective";
+            translation["exampleRu"] = QString::fromUtf8("Он говорит по-русски — пример %1.").arg(i);
+            translation["exampleTl"] = QString("He speaks \"Russian\", example %1.").arg(i);
+            translations.append(translation);
+        }
+        word["translations"] = translations;
+
+        QJsonArray sentences;
+        for (int i = 0; i < sentenceCount; ++i) {
+            QJsonObject sentence;
+            sentence["ru"] = QString::fromUtf8("Мы долго <b>говорили</b> о том, что %1 значит для нас, и не заметили, как прошёл день.")
+                                 .arg(words[i % words.size()]);
+            sentence["tl"] = QString("We talked for a long time about what \"%1\" means to us and did not notice the day go by.")
+                                 .arg(i);
+            sentence["id"] = 100000 + i;
+            sentence["ratings"] = QJsonArray{i % 5, (i * 7) % 5};
+            sentences.append(sentence);
+        }
+        word["sentences"] = sentences;
+
+        QJsonArray relateds;
+        for (int i = 0; i < sentenceCount / 10; ++i) {
+            relateds.append(QJsonObject{{"ru", words[i % words.size()]}, {"id", i}, {"type", "noun"}});
+        }
+        word["relateds"] = relateds;
+
+        // Translation resources and search state the page carries along
+        QJsonObject resources;
+        for (int i = 0; i < 200 + sentenceCount; ++i) {
+            resources[QString("key_%1").arg(i)] = QString("Interface string number %1 of the page").arg(i);
+        }
+
+        QJsonObject info{{"words", QJsonArray{word}}, {"search", QJsonObject{{"term", "говорить"}, {"results", QJsonArray()}}}};
+        QJsonObject pageProps{{"info", info}, {"_nextI18Next", QJsonObject{{"initialLocale", "en"}, {"store", resources}}}, {"__N_SSP", true}};
+        QJsonObject root{{"props", QJsonObject{{"pageProps", pageProps}}}, {"page", "/ru/[word]"}, {"buildId", "synthesized"}};
+
+        return "<!DOCTYPE html><html lang=\"en\"><head><meta charset=\"utf-8\"/></head><body><div id=\"__next\"></div>"
+               "<script id=\"__NEXT_DATA__\" type=\"application/json\">"
+               + QJsonDocument(root).toJson(QJsonDocument::Compact)
+               + "</script></body></html>";
+    }
+
+    struct Result
+    {
+        double microseconds;
+        double allocations;
+    };
+
+    template <typename Extract>
+    Result measure(const QByteArray &html, int minimumMs, Extract extract)
+    {
+        QJsonObject wordData;
+        extract(html, &wordData);  // warm up
+
+        qint64 allocationsBefore = allocationCount;
+        extract(html, &wordData);
+        qint64 allocations = allocationCount - allocationsBefore;
+
+        QElapsedTimer timer;
+        timer.start();
+        int iterations = 0;
+        do {
+            extract(html, &wordData);
+            iterations++;
+        } while (timer.elapsed() < minimumMs);
+
+        return {timer.nsecsElapsed() / 1000.0 / iterations, double(allocations)};
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("jsonbench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Compares OpenRussian::extractWordData with a full QJsonDocument parse.");
+    parser.addHelpOption();
+    QCommandLineOption pagesOption("pages", "Directory with fixture pages (*.html).", "dir",
+                                   QDir(QCoreApplication::applicationDirPath()).filePath("fixtures/pages"));
+    QCommandLineOption sentencesOption("sentences", "Comma-separated sentence counts of synthesized pages.", "list", "10,100,1000,5000");
+    QCommandLineOption timeOption("min-time", "Minimum measuring time per page and parser.", "ms", "300");
+    parser.addOptions({pagesOption, sentencesOption, timeOption});
+    parser.process(app);
+
+    QList<Page> pages;
+    QDir pagesDir(parser.value(pagesOption));
+    for (const QString &fileName : pagesDir.entryList(QStringList() << "*.html", QDir::Files, QDir::Name)) {
+        QFile file(pagesDir.filePath(fileName));
+        if (file.open(QIODevice::ReadOnly)) {
+            pages.append({fileName, file.readAll()});
+        }
+    }
+    for (const QString &count : parser.value(sentencesOption).split(',')) {
+        if (count.trimmed().isEmpty()) continue;
+        pages.append({QString("synthesized-%1").arg(count.trimmed()), synthesizePage(count.toInt())});
+    }
+
+    QTextStream out(stdout);
+    const int minimumMs = parser.value(timeOption).toInt();
+    bool allMatch = true;
+
+    out << QString("%1 %2 %3 %4 %5 %6 %7\n")
+               .arg("page", -24).arg("KB", 8).arg("document us", 12).arg("allocs", 9)
+               .arg("lazy us", 10).arg("allocs", 9).arg("speedup", 8);
+
+    for (const Page &page : pages) {
+        QJsonObject expected;
+        QJsonObject actual;
+        bool expectedFound = extractWithDocument(page.html, &expected);
+        bool actualFound = OpenRussian::extractWordData(page.html, &actual);
+        bool match = expectedFound == actualFound && usedFields(expected) == actual;
+        allMatch = allMatch && match;
+
+        Result document = measure(page.html, minimumMs, extractWithDocument);
+        Result lazy = measure(page.html, minimumMs, OpenRussian::extractWordData);
+
+        out << QString("%1 %2 %3 %4 %5 %6 %7%8\n")
+                   .arg(page.name, -24)
+                   .arg(page.html.size() / 1024.0, 8, 'f', 1)
+                   .arg(document.microseconds, 12, 'f', 1)
+                   .arg(document.allocations, 9, 'f', 0)
+                   .arg(lazy.microseconds, 10, 'f', 1)
+                   .arg(lazy.allocations, 9, 'f', 0)
+                   .arg(document.microseconds / lazy.microseconds, 7, 'f', 1)
+                   .arg(match ? "x" : "x  MISMATCH");
+        out.flush();
+    }
+
+    return allMatch ? 0 : 1;
+}
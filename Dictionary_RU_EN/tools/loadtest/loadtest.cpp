@@ -0,0 +1,232 @@
+#include "loadtest.h"
+#include "mainwindow.h"
+#include "mockserver.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <algorithm>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+namespace
+{
+    double percentile(QVector<double> values, double p)
+    {
+        if (values.isEmpty()) return 0.0;
+        std::sort(values.begin(), values.end());
+        int index = qBound(0, int(p * (values.size() - 1) + 0.5), values.size() - 1);
+        return values[index];
+    }
+}
+
+LoadTest::LoadTest(MainWindow *window, MockServer *server, const Options &options, QObject *parent)
+    : QObject(parent)
+    , window(window)
+    , server(server)
+    , options(options)
+    , issued(0)
+    , lookupDone(false)
+    , audioDone(false)
+    , notFound(0)
+    , audioFailures(0)
+    , timeouts(0)
+    , startMemory(0)
+    , peakMemory(0)
+{
+    connect(window, &MainWindow::lookupFinished, this, &LoadTest::onLookupFinished);
+    connect(window, &MainWindow::audioFinished, this, &LoadTest::onAudioFinished);
+
+    timeoutTimer.setSingleShot(true);
+    connect(&timeoutTimer, &QTimer::timeout, this, &LoadTest::onTimeout);
+
+    // Hand-written fixture words first, then synthesized ones; the list wraps so later
+    // lookups exercise the entry and audio caches
+    words << "говорить" << "дом" << "быть";
+    for (int i = words.size(); i < options.distinctWords; ++i) {
+        words << wordForIndex(i);
+    }
+
+    lookupLatencies.reserve(options.lookups);
+    audioLatencies.reserve(options.lookups);
+}
+
+QString LoadTest::wordForIndex(int index)
+{
+    static const QString letters = QString::fromUtf8("абвгдежзиклмнопрстуфхцчшщэюя");
+
+    QString word = QString::fromUtf8("сл");
+    do {
+        word += letters[index % letters.size()];
+        index /= letters.size();
+    } while (index > 0);
+    return word;
+}
+
+qint64 LoadTest::residentMemoryBytes()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return qint64(counters.WorkingSetSize);
+    }
+    return 0;
+#elif defined(Q_OS_LINUX)
+    // Second field of statm is the resident set size in pages
+    QFile file("/proc/self/statm");
+    if (!file.open(QIODevice::ReadOnly)) return 0;
+    QList<QByteArray> fields = file.readAll().split(' ');
+    return fields.value(1).toLongLong() * sysconf(_SC_PAGESIZE);
+#else
+    return 0;
+#endif
+}
+
+void LoadTest::start()
+{
+    window->setAutoPlay(options.audio);
+    window->setAudioPlaybackEnabled(false);
+
+    startMemory = peakMemory = residentMemoryBytes();
+    runTimer.start();
+    next();
+}
+
+void LoadTest::next()
+{
+    if (issued >= options.lookups) {
+        report();
+        return;
+    }
+
+    if (options.progressEvery > 0 && issued > 0 && issued % options.progressEvery == 0) {
+        peakMemory = qMax(peakMemory, residentMemoryBytes());
+        QTextStream(stdout) << QString("%1/%2 lookups, %3 MB resident\n")
+                               .arg(issued).arg(options.lookups)
+                               .arg(residentMemoryBytes() / 1048576.0, 0, 'f', 1);
+    }
+
+    currentWord = words[issued % words.size()];
+    issued++;
+    lookupDone = false;
+    audioDone = !options.audio;
+
+    timeoutTimer.start(options.timeoutMs);
+    lookupTimer.start();
+    window->lookupWord(currentWord);
+}
+
+void LoadTest::onLookupFinished(const QString &word, bool found)
+{
+    if (word != currentWord || lookupDone) return;
+
+    lookupDone = true;
+    lookupLatencies << lookupTimer.nsecsElapsed() / 1e6;
+    if (!found) {
+        notFound++;
+        // No pronunciation is fetched for words that were not found
+        audioDone = true;
+    }
+    completeCurrent();
+}
+
+void LoadTest::onAudioFinished(const QString &word, bool ok)
+{
+    if (word != currentWord || !lookupDone || audioDone) return;
+
+    audioDone = true;
+    audioLatencies << lookupTimer.nsecsElapsed() / 1e6 - lookupLatencies.last();
+    if (!ok) {
+        audioFailures++;
+    }
+    completeCurrent();
+}
+
+void LoadTest::onTimeout()
+{
+    timeouts++;
+    lookupDone = audioDone = true;
+    completeCurrent();
+}
+
+void LoadTest::completeCurrent()
+{
+    if (!lookupDone || !audioDone) return;
+
+    timeoutTimer.stop();
+    // Let the window finish processing the current event before the next lookup
+    QTimer::singleShot(0, this, &LoadTest::next);
+}
+
+void LoadTest::report()
+{
+    double seconds = runTimer.nsecsElapsed() / 1e9;
+    qint64 endMemory = residentMemoryBytes();
+    peakMemory = qMax(peakMemory, endMemory);
+    double growthMb = (endMemory - startMemory) / 1048576.0;
+    MockServer::Stats serverStats = server->stats();
+
+    QJsonObject result;
+    result["lookups"] = issued;
+    result["distinctWords"] = words.size();
+    result["seconds"] = seconds;
+    result["throughputPerSecond"] = seconds > 0 ? issued / seconds : 0.0;
+    result["lookupP50Ms"] = percentile(lookupLatencies, 0.50);
+    result["lookupP90Ms"] = percentile(lookupLatencies, 0.90);
+    result["lookupP99Ms"] = percentile(lookupLatencies, 0.99);
+    result["lookupMaxMs"] = percentile(lookupLatencies, 1.0);
+    result["audioP50Ms"] = percentile(audioLatencies, 0.50);
+    result["audioP99Ms"] = percentile(audioLatencies, 0.99);
+    result["notFound"] = notFound;
+    result["audioFailures"] = audioFailures;
+    result["timeouts"] = timeouts;
+    result["startMemoryMb"] = startMemory / 1048576.0;
+    result["endMemoryMb"] = endMemory / 1048576.0;
+    result["peakMemoryMb"] = peakMemory / 1048576.0;
+    result["memoryGrowthMb"] = growthMb;
+    result["serverRequests"] = serverStats.requests;
+    result["serverErrors"] = serverStats.errors;
+    result["serverThrottled"] = serverStats.throttled;
+    result["serverBytesSent"] = serverStats.bytesSent;
+
+    QTextStream out(stdout);
+    out << QString("Lookups:      %1 in %2 s (%3 lookups/s)\n")
+           .arg(issued).arg(seconds, 0, 'f', 2).arg(result["throughputPerSecond"].toDouble(), 0, 'f', 1);
+    out << QString("Lookup:       p50 %1 ms, p90 %2 ms, p99 %3 ms, max %4 ms\n")
+           .arg(result["lookupP50Ms"].toDouble(), 0, 'f', 2).arg(result["lookupP90Ms"].toDouble(), 0, 'f', 2)
+           .arg(result["lookupP99Ms"].toDouble(), 0, 'f', 2).arg(result["lookupMaxMs"].toDouble(), 0, 'f', 2);
+    out << QString("Audio:        p50 %1 ms, p99 %2 ms, %3 failures\n")
+           .arg(result["audioP50Ms"].toDouble(), 0, 'f', 2).arg(result["audioP99Ms"].toDouble(), 0, 'f', 2).arg(audioFailures);
+    out << QString("Errors:       %1 not found, %2 timeouts (server: %3 errors, %4 throttled)\n")
+           .arg(notFound).arg(timeouts).arg(serverStats.errors).arg(serverStats.throttled);
+    out << QString("Memory:       %1 MB -> %2 MB (peak %3 MB, growth %4 MB)\n")
+           .arg(startMemory / 1048576.0, 0, 'f', 1).arg(endMemory / 1048576.0, 0, 'f', 1)
+           .arg(peakMemory / 1048576.0, 0, 'f', 1).arg(growthMb, 0, 'f', 1);
+    out.flush();
+
+    if (!options.reportFile.isEmpty()) {
+        QFile file(options.reportFile);
+        if (file.open(QIODevice::WriteOnly)) {
+            file.write(QJsonDocument(result).toJson());
+        }
+    }
+
+    // Regression thresholds
+    int exitCode = 0;
+    if (options.maxP99Ms > 0 && result["lookupP99Ms"].toDouble() > options.maxP99Ms) {
+        QTextStream(stderr) << "FAIL: lookup p99 above " << options.maxP99Ms << " ms\n";
+        exitCode = 1;
+    }
+    if (options.maxMemoryGrowthMb > 0 && growthMb > options.maxMemoryGrowthMb) {
+        QTextStream(stderr) << "FAIL: memory growth above " << options.maxMemoryGrowthMb << " MB\n";
+        exitCode = 1;
+    }
+
+    emit finished(exitCode);
+}
@@ -0,0 +1,73 @@
+#ifndef LOADTEST_H
+#define LOADTEST_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+
+class MainWindow;
+class MockServer;
+
+// Drives MainWindow's lookup pipeline (fetch, parse, render, history, audio cache)
+// against the mock server and reports throughput, latency percentiles and memory growth.
+class LoadTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options
+    {
+        int lookups = 10000;
+        int distinctWords = 2000;
+        bool audio = true;
+        int timeoutMs = 30000;
+        int progressEvery = 1000;
+        QString reportFile;
+        double maxP99Ms = 0.0;          // fail the run above this, 0 = no limit
+        double maxMemoryGrowthMb = 0.0; // fail the run above this, 0 = no limit
+    };
+
+    LoadTest(MainWindow *window, MockServer *server, const Options &options, QObject *parent = nullptr);
+
+    void start();
+
+signals:
+    void finished(int exitCode);
+
+private slots:
+    void onLookupFinished(const QString &word, bool found);
+    void onAudioFinished(const QString &word, bool ok);
+    void onTimeout();
+
+private:
+    void next();
+    void completeCurrent();
+    void report();
+    static QString wordForIndex(int index);
+    static qint64 residentMemoryBytes();
+
+    MainWindow *window;
+    MockServer *server;
+    Options options;
+
+    QStringList words;
+    int issued;
+    QString currentWord;
+    bool lookupDone;
+    bool audioDone;
+    QElapsedTimer lookupTimer;
+    QElapsedTimer runTimer;
+    QTimer timeoutTimer;
+
+    QVector<double> lookupLatencies;
+    QVector<double> audioLatencies;
+    int notFound;
+    int audioFailures;
+    int timeouts;
+    qint64 startMemory;
+    qint64 peakMemory;
+};
+
+#endif // LOADTEST_H
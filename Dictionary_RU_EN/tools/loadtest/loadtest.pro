@@ -0,0 +1,30 @@
+# End-to-end load and regression harness for the lookup pipeline.
+# Builds the application sources against a local mock OpenRussian/TTS server:
+#   loadtest --lookups 10000 --latency 20 --throttle-rate 0.01 --report result.json
+QT      += core gui network
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+CONFIG -= debug_and_release
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+include(../../Dictionary_RU_EN.pri)
+
+SOURCES += \
+    loadtest.cpp \
+    main.cpp \
+    mockserver.cpp
+
+HEADERS += \
+    loadtest.h \
+    mockserver.h
+
+win32: LIBS += -lpsapi
+
+DESTDIR = ./
+
+# Fixture pages and clips are looked up next to the executable
+fixtures.path = $$OUT_PWD/fixtures
+fixtures.files = $$PWD/fixtures/pages
+COPIES += fixtures
@@ -0,0 +1,105 @@
+#include "loadtest.h"
+#include "mainwindow.h"
+#include "mockserver.h"
+#include "openrussian.h"
+#include "texttospeech.h"
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+int main(int argc, char *argv[])
+{
+    // Run without a display unless asked otherwise
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+    app.setApplicationName("loadtest");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("End-to-end load test of the dictionary lookup pipeline against a local mock "
+                                     "OpenRussian/TTS server. With --serve-only, just runs the mock server so the "
+                                     "application can be started with --openrussian-url and --tts-url.");
+    parser.addHelpOption();
+
+    QCommandLineOption lookupsOption("lookups", "Number of lookups.", "n", "10000");
+    QCommandLineOption distinctOption("distinct", "Number of distinct words.", "n", "2000");
+    QCommandLineOption noAudioOption("no-audio", "Do not download pronunciations.");
+    QCommandLineOption latencyOption("latency", "Server latency in ms.", "ms", "20");
+    QCommandLineOption jitterOption("jitter", "Random extra latency in ms.", "ms", "10");
+    QCommandLineOption bandwidthOption("bandwidth", "Server bandwidth in bytes/s, 0 = unlimited.", "bytes", "0");
+    QCommandLineOption errorRateOption("error-rate", "Share of requests answered with 500.", "rate", "0");
+    QCommandLineOption throttleRateOption("throttle-rate", "Share of requests answered with 429.", "rate", "0");
+    QCommandLineOption sentencesOption("sentences", "Sentences per synthesized entry.", "n", "10");
+    QCommandLineOption fixturesOption("fixtures", "Directory with pages/ and audio/ fixtures.", "dir",
+                                      QDir(QCoreApplication::applicationDirPath()).filePath("fixtures"));
+    QCommandLineOption workDirOption("workdir", "Directory for history and caches (default: temporary).", "dir");
+    QCommandLineOption reportOption("report", "Write the results as JSON to this file.", "file");
+    QCommandLineOption maxP99Option("max-p99", "Fail if lookup p99 exceeds this many ms.", "ms", "0");
+    QCommandLineOption maxGrowthOption("max-memory-growth", "Fail if memory grows by more than this many MB.", "mb", "0");
+    QCommandLineOption seedOption("seed", "Random seed for latency and error injection.", "n", "1");
+    QCommandLineOption portOption("port", "Mock server port (default: any free port).", "port", "0");
+    QCommandLineOption serveOnlyOption("serve-only", "Only run the mock server.");
+
+    parser.addOptions({lookupsOption, distinctOption, noAudioOption, latencyOption, jitterOption,
+                       bandwidthOption, errorRateOption, throttleRateOption, sentencesOption, fixturesOption,
+                       workDirOption, reportOption, maxP99Option, maxGrowthOption, seedOption, portOption,
+                       serveOnlyOption});
+    parser.process(app);
+
+    // Paths given on the command line are relative to where we were started,
+    // not to the working directory chosen below
+    MockServer::Options serverOptions;
+    serverOptions.fixturesDirectory = QFileInfo(parser.value(fixturesOption)).absoluteFilePath();
+    serverOptions.latencyMs = parser.value(latencyOption).toInt();
+    serverOptions.jitterMs = parser.value(jitterOption).toInt();
+    serverOptions.bytesPerSecond = parser.value(bandwidthOption).toLongLong();
+    serverOptions.errorRate = parser.value(errorRateOption).toDouble();
+    serverOptions.throttleRate = parser.value(throttleRateOption).toDouble();
+    serverOptions.sentencesPerEntry = parser.value(sentencesOption).toInt();
+    serverOptions.seed = parser.value(seedOption).toUInt();
+
+    MockServer server(serverOptions);
+    if (!server.listen(quint16(parser.value(portOption).toUInt()))) {
+        QTextStream(stderr) << "Could not start the mock server\n";
+        return 2;
+    }
+    QTextStream out(stdout);
+    out << "Mock server listening on " << server.url() << "\n";
+    out.flush();
+
+    if (parser.isSet(serveOnlyOption)) {
+        return app.exec();
+    }
+
+    QString reportFile = parser.isSet(reportOption) ? QFileInfo(parser.value(reportOption)).absoluteFilePath() : QString();
+
+    // History, entry cache and audio cache are relative to the working directory
+    QTemporaryDir temporaryDir;
+    QString workDir = parser.isSet(workDirOption) ? parser.value(workDirOption) : temporaryDir.path();
+    QDir().mkpath(workDir);
+    QDir::setCurrent(workDir);
+
+    OpenRussian::setBaseUrl(server.url());
+    TextToSpeech::setBaseUrl(server.url());
+
+    MainWindow window;
+
+    LoadTest::Options options;
+    options.lookups = parser.value(lookupsOption).toInt();
+    options.distinctWords = qMax(3, parser.value(distinctOption).toInt());
+    options.audio = !parser.isSet(noAudioOption);
+    options.reportFile = reportFile;
+    options.maxP99Ms = parser.value(maxP99Option).toDouble();
+    options.maxMemoryGrowthMb = parser.value(maxGrowthOption).toDouble();
+
+    LoadTest loadTest(&window, &server, options);
+    QObject::connect(&loadTest, &LoadTest::finished, &app, &QCoreApplication::exit);
+    loadTest.start();
+
+    return app.exec();
+}
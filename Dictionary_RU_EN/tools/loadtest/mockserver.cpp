@@ -0,0 +1,236 @@
+#include "mockserver.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPointer>
+#include <QTimer>
+#include <QUrlQuery>
+
+namespace
+{
+    const int SliceIntervalMs = 50;
+
+    QByteArray statusText(int status)
+    {
+        switch (status) {
+        case 200: return "OK";
+        case 404: return "Not Found";
+        case 429: return "Too Many Requests";
+        default: return "Internal Server Error";
+        }
+    }
+
+    // About one second of silence: MPEG-1 Layer III frames, 128 kbit/s, 44.1 kHz, mono
+    QByteArray makeSilentClip()
+    {
+        const int frameLength = 144 * 128000 / 44100;
+        QByteArray frame(frameLength, '\0');
+        frame[0] = char(0xFF);
+        frame[1] = char(0xFB);
+        frame[2] = char(0x90);
+        frame[3] = char(0xC0);
+        return frame.repeated(38);
+    }
+}
+
+MockServer::MockServer(const Options &options, QObject *parent)
+    : QObject(parent)
+    , options(options)
+    , random(options.seed)
+    , silentClip(makeSilentClip())
+{
+    QDir pages(QDir(options.fixturesDirectory).filePath("pages"));
+    for (const QString &fileName : pages.entryList(QStringList() << "*.html", QDir::Files)) {
+        QFile file(pages.filePath(fileName));
+        if (file.open(QIODevice::ReadOnly)) {
+            fixturePages.insert(QFileInfo(fileName).completeBaseName(), file.readAll());
+        }
+    }
+
+    connect(&server, &QTcpServer::newConnection, this, &MockServer::onNewConnection);
+}
+
+bool MockServer::listen(quint16 port)
+{
+    return server.listen(QHostAddress::LocalHost, port);
+}
+
+QString MockServer::url() const
+{
+    return QString("http://127.0.0.1:%1").arg(server.serverPort());
+}
+
+MockServer::Stats MockServer::stats() const
+{
+    return counters;
+}
+
+void MockServer::onNewConnection()
+{
+    while (QTcpSocket *socket = server.nextPendingConnection()) {
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+            // Wait for the complete request header; bodies are never sent to us
+            QByteArray buffer = socket->property("buffer").toByteArray() + socket->readAll();
+            int headerEnd = buffer.indexOf("\r\n\r\n");
+            if (headerEnd < 0) {
+                socket->setProperty("buffer", buffer);
+                return;
+            }
+            socket->setProperty("buffer", QVariant());
+
+            QList<QByteArray> requestLine = buffer.left(buffer.indexOf("\r\n")).split(' ');
+            handleRequest(socket, requestLine.value(1));
+        });
+    }
+}
+
+void MockServer::handleRequest(QTcpSocket *socket, const QByteArray &path)
+{
+    counters.requests++;
+
+    int status = 200;
+    QByteArray contentType;
+    QByteArray body;
+
+    double roll = random.generateDouble();
+    QUrl url(QString::fromLatin1(path));
+
+    if (roll < options.throttleRate) {
+        status = 429;
+        counters.throttled++;
+    } else if (roll < options.throttleRate + options.errorRate) {
+        status = 500;
+        counters.errors++;
+    } else if (url.path(QUrl::FullyDecoded).startsWith("/ru/")) {
+        contentType = "text/html; charset=utf-8";
+        body = pageForWord(url.path(QUrl::FullyDecoded).mid(4));
+        counters.pages++;
+    } else if (url.path() == "/translate_tts") {
+        contentType = "audio/mpeg";
+        body = audioForText(QUrlQuery(url).queryItemValue("q", QUrl::FullyDecoded));
+        counters.audioClips++;
+    } else {
+        status = 404;
+    }
+
+    int delay = options.latencyMs;
+    if (options.jitterMs > 0) {
+        delay += random.bounded(options.jitterMs + 1);
+    }
+
+    QPointer<QTcpSocket> guard(socket);
+    QTimer::singleShot(delay, this, [this, guard, status, contentType, body]() {
+        if (guard) {
+            respond(guard, status, contentType, body);
+        }
+    });
+}
+
+void MockServer::respond(QTcpSocket *socket, int status, const QByteArray &contentType, const QByteArray &body)
+{
+    QByteArray response = "HTTP/1.1 " + QByteArray::number(status) + " " + statusText(status) + "\r\n";
+    if (!contentType.isEmpty()) {
+        response += "Content-Type: " + contentType + "\r\n";
+    }
+    if (status == 429) {
+        response += "Retry-After: 1\r\n";
+    }
+    response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    response += "Connection: close\r\n\r\n";
+    response += body;
+
+    sendSlice(socket, response);
+}
+
+void MockServer::sendSlice(QTcpSocket *socket, QByteArray data)
+{
+    if (options.bytesPerSecond <= 0) {
+        counters.bytesSent += data.size();
+        socket->write(data);
+        socket->disconnectFromHost();
+        return;
+    }
+
+    // Throttle by writing a slice every SliceIntervalMs
+    qint64 sliceSize = qMax<qint64>(1, options.bytesPerSecond * SliceIntervalMs / 1000);
+    QByteArray slice = data.left(int(sliceSize));
+    data.remove(0, slice.size());
+    counters.bytesSent += slice.size();
+    socket->write(slice);
+
+    if (data.isEmpty()) {
+        socket->disconnectFromHost();
+        return;
+    }
+
+    QPointer<QTcpSocket> guard(socket);
+    QTimer::singleShot(SliceIntervalMs, this, [this, guard, data]() {
+        if (guard) {
+            sendSlice(guard, data);
+        }
+    });
+}
+
+QByteArray MockServer::pageForWord(const QString &word)
+{
+    QByteArray page = fixturePages.value(word);
+    return page.isEmpty() ? synthesizePage(word) : page;
+}
+
+QByteArray MockServer::audioForText(const QString &text)
+{
+    QFile file(QDir(options.fixturesDirectory).filePath("audio/" + text + ".mp3"));
+    if (file.open(QIODevice::ReadOnly)) {
+        return file.readAll();
+    }
+    return silentClip;
+}
+
+QByteArray MockServer::synthesizePage(const QString &word) const
+{
+    // Same shape as the __NEXT_DATA__ of a fixture page
+    QJsonArray translations;
+    for (int i = 1; i <= 3; ++i) {
+        QJsonObject translation;
+        translation["tls"] = QJsonArray() << QString("meaning %1 of %2").arg(i).arg(word) << QString("sense %1").arg(i);
+        translation["info"] = "";
+        translation["exampleRu"] = QString("Пример %1 со словом %2.").arg(i).arg(word);
+        translation["exampleTl"] = QString("Example %1 with the word %2.").arg(i).arg(word);
+        translations.append(translation);
+    }
+
+    QJsonArray sentences;
+    for (int i = 0; i < options.sentencesPerEntry; ++i) {
+        QJsonObject sentence;
+        sentence["ru"] = QString("Это предложение номер %1, в котором встречается слово <b>%2</b>.").arg(i + 1).arg(word);
+        sentence["tl"] = QString("This is sentence number %1 that contains the word %2.").arg(i + 1).arg(word);
+        sentence["id"] = i + 1;
+        sentences.append(sentence);
+    }
+
+    QJsonObject wordData;
+    wordData["ru"] = word;
+    wordData["accented"] = word;
+    wordData["translations"] = translations;
+    wordData["sentences"] = sentences;
+
+    QJsonObject info;
+    info["words"] = QJsonArray() << wordData;
+    QJsonObject pageProps;
+    pageProps["info"] = info;
+    QJsonObject props;
+    props["pageProps"] = pageProps;
+    QJsonObject root;
+    root["props"] = props;
+    root["page"] = "/ru/[word]";
+    root["buildId"] = "synthetic";
+
+    QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Compact);
+    return "<!DOCTYPE html><html lang=\"en\"><head><meta charset=\"utf-8\"/><title>" + word.toUtf8()
+            + "</title></head><body><div id=\"__next\"></div>"
+            + "<script id=\"__NEXT_DATA__\" type=\"application/json\">" + json + "</script></body></html>\n";
+}
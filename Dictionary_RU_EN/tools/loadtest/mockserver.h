@@ -0,0 +1,71 @@
+#ifndef MOCKSERVER_H
+#define MOCKSERVER_H
+
+#include <QObject>
+#include <QHash>
+#include <QRandomGenerator>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QUrl>
+
+// Local stand-in for en.openrussian.org and the Google TTS endpoint.
+// Serves the hand-written fixture pages in fixtures/pages/<word>.html
+// (synthesizing a page for other words) and MP3 clips from fixtures/audio
+// (one second of generated silence otherwise), with injected latency,
+// bandwidth limits, server errors and 429 throttling.
+// The server runs inside the load test process, so all fixture pages are read
+// at construction and nothing is kept per request: the memory it holds is part
+// of the starting figure and does not show up as growth.
+class MockServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options
+    {
+        QString fixturesDirectory;
+        int latencyMs = 0;
+        int jitterMs = 0;
+        qint64 bytesPerSecond = 0;  // 0 = unlimited
+        double errorRate = 0.0;     // share of requests answered with 500
+        double throttleRate = 0.0;  // share of requests answered with 429
+        int sentencesPerEntry = 10;
+        quint32 seed = 1;
+    };
+
+    struct Stats
+    {
+        qint64 requests = 0;
+        qint64 pages = 0;
+        qint64 audioClips = 0;
+        qint64 errors = 0;
+        qint64 throttled = 0;
+        qint64 bytesSent = 0;
+    };
+
+    MockServer(const Options &options, QObject *parent = nullptr);
+
+    bool listen(quint16 port = 0);
+    QString url() const;
+    Stats stats() const;
+
+private slots:
+    void onNewConnection();
+
+private:
+    void handleRequest(QTcpSocket *socket, const QByteArray &path);
+    void respond(QTcpSocket *socket, int status, const QByteArray &contentType, const QByteArray &body);
+    void sendSlice(QTcpSocket *socket, QByteArray data);
+    QByteArray pageForWord(const QString &word);
+    QByteArray audioForText(const QString &text);
+    QByteArray synthesizePage(const QString &word) const;
+
+    Options options;
+    Stats counters;
+    QTcpServer server;
+    QRandomGenerator random;
+    QHash<QString, QByteArray> fixturePages;
+    QByteArray silentClip;
+};
+
+#endif // MOCKSERVER_H